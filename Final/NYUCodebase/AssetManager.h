@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ShaderProgram.h"
+#include "TextureCache.h"
+
+// decoded assets allowed to wait for the render thread before workers stop
+// decoding more, which bounds the memory held by pixels not yet uploaded
+#define ASSET_UPLOAD_QUEUE 4
+
+typedef int AssetHandle;
+
+enum AssetState { ASSET_DECODING, ASSET_UPLOAD_QUEUED, ASSET_READY, ASSET_FAILED };
+
+struct AssetProgress {
+    int total;
+    int decoded;
+    int ready;
+    int failed;
+    // finished assets, ready or failed, as a share of all requested so far
+    float fraction;
+};
+
+// Loads assets on worker threads and hands back a handle at once. Anything
+// that needs GL waits in a bounded queue until the render thread calls
+// Update(), which uploads as many as fit in its time budget; everything else
+// is ready as soon as a worker has decoded it.
+//
+// Requests, Update() and the accessors are for the render thread only.
+class AssetManager {
+    public:
+        // workers below 1 still get one thread, so loading never blocks the caller.
+        // Textures are cached in textureCacheDirectory; see TextureCache.
+        AssetManager(int workers, const std::string &textureCacheDirectory = std::string());
+        ~AssetManager();
+
+        // decode runs on a worker; upload, if given, runs afterwards on the
+        // render thread. Either one returning false fails the asset.
+        AssetHandle Load(const std::function<bool()> &decode, const std::function<bool()> &upload = std::function<bool()>());
+        // Decoded on a worker, or mapped from the texture cache, and uploaded in
+        // the smallest format that draws the same; Texture() is 0 until ready.
+        AssetHandle LoadTexture(const std::string &fileName, bool nearest);
+        // Reads both files on a worker; link compiles the sources on the render
+        // thread and returns whether they linked.
+        AssetHandle LoadShader(const std::string &vertexFile, const std::string &fragmentFile,
+                               const std::function<bool(const std::string &, const std::string &)> &link);
+
+        // Runs queued uploads until budget seconds have passed, always at least
+        // one if any is waiting. Returns how many ran.
+        int Update(float budget);
+        // Uploads, and waits for workers, until the asset or everything is finished.
+        void Wait(AssetHandle handle);
+        void Finish();
+
+        AssetState State(AssetHandle handle) const;
+        GLuint Texture(AssetHandle handle) const;
+        AssetProgress Progress() const;
+        bool Done() const;
+        const TextureCache &Textures() const;
+
+    private:
+        AssetManager(const AssetManager &);
+        AssetManager &operator=(const AssetManager &);
+
+        struct Asset {
+            Asset() : state(ASSET_DECODING), nearest(false), texture(0) {}
+            std::function<bool()> decode;
+            std::function<bool()> upload;
+            std::atomic<int> state;
+            // textures: image holds the pixels between decode and upload
+            std::string fileName;
+            bool nearest;
+            CachedTexture image;
+            GLuint texture;
+            // shaders
+            std::string sources[2];
+        };
+
+        AssetHandle Queue(Asset *asset);
+        void WorkerLoop();
+        bool DecodeTexture(Asset &asset);
+        bool UploadTexture(Asset &asset);
+        void Finished(Asset &asset, bool success);
+
+        std::vector<std::unique_ptr<Asset>> assets;
+        TextureCache textures;
+
+        std::mutex lock;
+        std::condition_variable decodeReady;
+        std::condition_variable uploadReady;
+        std::condition_variable uploadSpace;
+        std::deque<Asset *> decodeQueue;
+        std::deque<Asset *> uploadQueue;
+        bool running;
+        std::vector<std::thread> threads;
+
+        std::atomic<int> decoded;
+        std::atomic<int> ready;
+        std::atomic<int> failed;
+};
@@ -0,0 +1,224 @@
+#include "AudioMixer.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+// the output ring is sized for up to this many channels
+#define AUDIO_MAX_CHANNELS 8
+
+AudioMixer::AudioMixer(int voiceCount) : commands(AUDIO_COMMAND_CAPACITY), output(AUDIO_BUFFER_FRAMES * AUDIO_MAX_CHANNELS), channels(2),
+    running(false), queueHighWater(0), queueFull(0), underruns(0), mixedFrames(0) {
+    voices.Open(voiceCount);
+}
+
+AudioMixer::~AudioMixer() {
+    Close();
+}
+
+int AudioMixer::Register(Mix_Chunk *chunk, int maxVoices, int priority) {
+    return voices.Register(chunk, maxVoices, priority);
+}
+
+void AudioMixer::Push(const AudioCommand &command) {
+    if(!commands.Push(command)) {
+        queueFull.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // only this thread raises it, so a plain compare is enough
+    int depth = commands.Size();
+    if(depth > queueHighWater.load(std::memory_order_relaxed)) {
+        queueHighWater.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void AudioMixer::Play(int sound) {
+    AudioCommand command;
+    command.type = AUDIO_PLAY;
+    command.sound = sound;
+    command.volume = 0.0f;
+    Push(command);
+}
+
+void AudioMixer::StopSound(int sound) {
+    AudioCommand command;
+    command.type = AUDIO_STOP;
+    command.sound = sound;
+    command.volume = 0.0f;
+    Push(command);
+}
+
+void AudioMixer::SetVolume(int sound, float volume) {
+    AudioCommand command;
+    command.type = AUDIO_VOLUME;
+    command.sound = sound;
+    command.volume = volume;
+    Push(command);
+}
+
+void AudioMixer::EndFrame() {
+    AudioCommand command;
+    command.type = AUDIO_END_FRAME;
+    command.sound = -1;
+    command.volume = 0.0f;
+    Push(command);
+}
+
+void AudioMixer::Drain() {
+    AudioCommand command;
+    while(commands.Pop(command)) {
+        switch(command.type) {
+            case AUDIO_PLAY:
+                voices.Play(command.sound);
+                break;
+            case AUDIO_STOP:
+                voices.Stop(command.sound);
+                break;
+            case AUDIO_VOLUME:
+                voices.SetVolume(command.sound, command.volume);
+                break;
+            case AUDIO_END_FRAME:
+                voices.EndFrame();
+                break;
+        }
+    }
+}
+
+void AudioMixer::MixBlock(Sint16 *out, int frames, int channels) {
+    int count = frames * channels;
+    accumulator.assign(count, 0);
+    voices.Mix(accumulator.data(), frames, channels);
+    for(int i = 0; i < count; i++) {
+        int sample = accumulator[i];
+        out[i] = (Sint16)(sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample));
+    }
+    mixedFrames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+void AudioMixer::Render(Sint16 *out, int frames, int channels) {
+    Drain();
+    MixBlock(out, frames, channels);
+}
+
+bool AudioMixer::Open() {
+    int frequency;
+    Uint16 format;
+    int deviceChannels;
+    if(!Mix_QuerySpec(&frequency, &format, &deviceChannels)) {
+        std::cout << "Sound effects disabled, audio is not open: " << Mix_GetError() << "\n";
+        return false;
+    }
+    if(format != AUDIO_S16SYS || deviceChannels > AUDIO_MAX_CHANNELS) {
+        std::cout << "Sound effects disabled, the mixer only writes 16-bit output\n";
+        return false;
+    }
+    channels = deviceChannels;
+    block.resize(AUDIO_MIX_BLOCK * channels);
+    running = true;
+    thread = std::thread(&AudioMixer::MixerLoop, this);
+    Mix_SetPostMix(&AudioMixer::PostMix, this);
+    return true;
+}
+
+void AudioMixer::Close() {
+    if(!running) {
+        return;
+    }
+    Mix_SetPostMix(NULL, NULL);
+    running = false;
+    thread.join();
+}
+
+void AudioMixer::MixerLoop() {
+    int lead = AUDIO_BUFFER_FRAMES * channels;
+    int blockSamples = AUDIO_MIX_BLOCK * channels;
+    while(running) {
+        // commands are applied a block at a time, so they are heard at most one ring late
+        Drain();
+        if(output.Size() + blockSamples <= lead) {
+            MixBlock(block.data(), AUDIO_MIX_BLOCK, channels);
+            output.Write(block.data(), blockSamples);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void AudioMixer::PostMix(void *mixer, Uint8 *stream, int length) {
+    // runs on SDL's audio thread with the device locked: no allocation, no waiting
+    AudioMixer *self = (AudioMixer *)mixer;
+    Sint16 *samples = (Sint16 *)stream;
+    int wanted = length / (int)sizeof(Sint16);
+    Sint16 piece[512];
+    while(wanted > 0) {
+        int read = self->output.Read(piece, wanted < 512 ? wanted : 512);
+        if(read == 0) {
+            self->underruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        for(int i = 0; i < read; i++) {
+            int sample = samples[i] + piece[i];
+            samples[i] = (Sint16)(sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample));
+        }
+        samples += read;
+        wanted -= read;
+    }
+}
+
+AudioStats AudioMixer::Stats() const {
+    AudioStats stats;
+    stats.queueDepth = commands.Size();
+    stats.queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+    stats.queueFull = queueFull.load(std::memory_order_relaxed);
+    stats.underruns = underruns.load(std::memory_order_relaxed);
+    stats.mixedFrames = mixedFrames.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const VoiceStats &AudioMixer::VoiceCounts() const {
+    return voices.stats;
+}
+
+static void writeUint32(std::vector<unsigned char> &file, unsigned int value) {
+    for(int i = 0; i < 4; i++) {
+        file.push_back((unsigned char)(value >> (i * 8)));
+    }
+}
+
+static void writeUint16(std::vector<unsigned char> &file, unsigned int value) {
+    file.push_back((unsigned char)value);
+    file.push_back((unsigned char)(value >> 8));
+}
+
+static void writeTag(std::vector<unsigned char> &file, const char *tag) {
+    file.insert(file.end(), tag, tag + 4);
+}
+
+bool AudioMixer::WriteWAV(const std::string &fileName, const std::vector<Sint16> &samples, int frequency, int channels) {
+    unsigned int dataSize = (unsigned int)(samples.size() * sizeof(Sint16));
+    std::vector<unsigned char> file;
+    writeTag(file, "RIFF");
+    writeUint32(file, 36 + dataSize);
+    writeTag(file, "WAVE");
+    writeTag(file, "fmt ");
+    writeUint32(file, 16);
+    // uncompressed PCM
+    writeUint16(file, 1);
+    writeUint16(file, channels);
+    writeUint32(file, frequency);
+    writeUint32(file, frequency * channels * sizeof(Sint16));
+    writeUint16(file, channels * sizeof(Sint16));
+    writeUint16(file, 16);
+    writeTag(file, "data");
+    writeUint32(file, dataSize);
+    for(Sint16 sample : samples) {
+        writeUint16(file, (Uint16)sample);
+    }
+
+    std::ofstream outfile(fileName.c_str(), std::ios::binary);
+    if(outfile.fail()) {
+        std::cout << "Unable to write " << fileName << "\n";
+        return false;
+    }
+    outfile.write((const char *)file.data(), file.size());
+    return !outfile.fail();
+}
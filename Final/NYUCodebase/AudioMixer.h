@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL_mixer.h>
+#include "SPSCQueue.h"
+#include "VoiceManager.h"
+
+// commands the simulation can have in flight before new ones are dropped
+#define AUDIO_COMMAND_CAPACITY 256
+// frames mixed per pass on the mixer thread
+#define AUDIO_MIX_BLOCK 256
+// mixed frames kept ready for the output callback; effects are this late at most
+#define AUDIO_BUFFER_FRAMES 2048
+
+enum AudioCommandType { AUDIO_PLAY, AUDIO_STOP, AUDIO_VOLUME, AUDIO_END_FRAME };
+
+struct AudioCommand {
+    AudioCommandType type;
+    int sound;
+    float volume;
+};
+
+struct AudioStats {
+    // commands waiting right now, and the most that ever waited at once
+    int queueDepth;
+    int queueHighWater;
+    // commands dropped because the queue was full
+    unsigned int queueFull;
+    // output callbacks that found fewer mixed frames than they needed
+    unsigned int underruns;
+    unsigned int mixedFrames;
+};
+
+// Sound effects mixed off the simulation thread. The simulation only pushes
+// commands into a wait-free queue; the mixer thread drains it, runs the
+// VoiceManager and keeps a ring of mixed PCM topped up, and SDL_mixer's
+// post-mix hook adds that ring on top of the music. Nothing on the simulation
+// side takes the audio lock.
+//
+// Without Open() the same mixing runs synchronously through Render(), for
+// headless checks with the dummy driver or writing the result to a WAV file.
+class AudioMixer {
+    public:
+        AudioMixer(int voiceCount);
+        ~AudioMixer();
+
+        // Register every sound before Open() or the first Render().
+        int Register(Mix_Chunk *chunk, int maxVoices, int priority);
+
+        // Simulation thread; none of these block.
+        void Play(int sound);
+        void StopSound(int sound);
+        void SetVolume(int sound, float volume);
+        // Ends the simulation step, closing the window in which repeats of a sound are merged.
+        void EndFrame();
+
+        // Starts the mixer thread and hooks it into the open SDL_mixer device.
+        // Returns false, leaving effects silent, unless the device is 16-bit.
+        bool Open();
+        void Close();
+
+        // Offline mixing, only while the mixer is not open: applies queued
+        // commands and writes frames of channels-interleaved samples to out.
+        void Render(Sint16 *out, int frames, int channels);
+        static bool WriteWAV(const std::string &fileName, const std::vector<Sint16> &samples, int frequency, int channels);
+
+        AudioStats Stats() const;
+        // Owned by the mixer thread; read it after Close() or between Render() calls.
+        const VoiceStats &VoiceCounts() const;
+
+    private:
+        AudioMixer(const AudioMixer &);
+        AudioMixer &operator=(const AudioMixer &);
+
+        void Push(const AudioCommand &command);
+        void Drain();
+        void MixBlock(Sint16 *out, int frames, int channels);
+        void MixerLoop();
+        static void PostMix(void *mixer, Uint8 *stream, int length);
+
+        VoiceManager voices;
+        SPSCQueue<AudioCommand> commands;
+        SPSCQueue<Sint16> output;
+        // mixer thread only
+        std::vector<int> accumulator;
+        std::vector<Sint16> block;
+        int channels;
+
+        std::thread thread;
+        std::atomic<bool> running;
+        std::atomic<int> queueHighWater;
+        std::atomic<unsigned int> queueFull;
+        std::atomic<unsigned int> underruns;
+        std::atomic<unsigned int> mixedFrames;
+};
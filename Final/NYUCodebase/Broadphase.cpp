@@ -0,0 +1,144 @@
+#include "Broadphase.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash() : cellSize(0.25f) {
+    Clear();
+}
+
+SpatialHash::SpatialHash(float cellSize) : cellSize(cellSize) {
+    Clear();
+}
+
+bool SpatialHash::CellEntry::operator<(const CellEntry &other) const {
+    if(cell != other.cell) {
+        return cell < other.cell;
+    }
+    return proxy < other.proxy;
+}
+
+void SpatialHash::Clear() {
+    proxies.clear();
+    entries.clear();
+    stats.proxies = 0;
+    stats.cellEntries = 0;
+    stats.candidatePairs = 0;
+    stats.bruteForcePairs = 0;
+}
+
+int SpatialHash::Insert(int index, unsigned int layer, unsigned int mask, float minX, float minY, float maxX, float maxY) {
+    BroadphaseProxy proxy;
+    proxy.index = index;
+    proxy.layer = layer;
+    proxy.mask = mask;
+    int id = (int)proxies.size();
+    proxies.push_back(proxy);
+
+    int x0 = (int)std::floor(minX / cellSize);
+    int y0 = (int)std::floor(minY / cellSize);
+    int x1 = (int)std::floor(maxX / cellSize);
+    int y1 = (int)std::floor(maxY / cellSize);
+    for(int y = y0; y <= y1; y++) {
+        for(int x = x0; x <= x1; x++) {
+            CellEntry entry;
+            // the play field is only a few cells across, so 16 bits per axis packs the cell exactly
+            entry.cell = ((unsigned int)(x + 32768) << 16) | ((unsigned int)(y + 32768) & 0xFFFF);
+            entry.proxy = id;
+            entries.push_back(entry);
+        }
+    }
+    return id;
+}
+
+bool SpatialHash::Accepts(const BroadphaseProxy &a, const BroadphaseProxy &b) const {
+    return (a.mask & b.layer) && (b.mask & a.layer);
+}
+
+void SpatialHash::PairsInCells(int firstCell, int lastCell, std::vector<std::pair<int, int>> &pairs) const {
+    for(int cell = firstCell; cell < lastCell; cell++) {
+        int start = cellStarts[cell];
+        int end = cellStarts[cell + 1];
+        for(int i = start; i < end; i++) {
+            for(int j = i + 1; j < end; j++) {
+                int a = entries[i].proxy;
+                int b = entries[j].proxy;
+                if(Accepts(proxies[a], proxies[b])) {
+                    pairs.push_back(std::make_pair(a, b));
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::FindPairs(std::vector<std::pair<int, int>> &pairs, JobSystem *jobs) {
+    pairs.clear();
+    std::sort(entries.begin(), entries.end());
+    cellStarts.clear();
+    for(size_t i = 0; i < entries.size(); i++) {
+        if(i == 0 || entries[i].cell != entries[i - 1].cell) {
+            cellStarts.push_back((int)i);
+        }
+    }
+    int cells = (int)cellStarts.size();
+    cellStarts.push_back((int)entries.size());
+
+    if(jobs && cells > BROADPHASE_CELL_GRAIN) {
+        int chunks = (cells + BROADPHASE_CELL_GRAIN - 1) / BROADPHASE_CELL_GRAIN;
+        if((int)chunkPairs.size() < chunks) {
+            chunkPairs.resize(chunks);
+        }
+        jobs->ParallelFor(cells, BROADPHASE_CELL_GRAIN, [this](int begin, int end) {
+            std::vector<std::pair<int, int>> &found = chunkPairs[begin / BROADPHASE_CELL_GRAIN];
+            found.clear();
+            PairsInCells(begin, end, found);
+        });
+        for(int chunk = 0; chunk < chunks; chunk++) {
+            pairs.insert(pairs.end(), chunkPairs[chunk].begin(), chunkPairs[chunk].end());
+        }
+    } else {
+        PairsInCells(0, cells, pairs);
+    }
+    // bodies spanning several cells report the same pair more than once
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    stats.proxies = (int)proxies.size();
+    stats.cellEntries = (int)entries.size();
+    stats.candidatePairs = (int)pairs.size();
+    stats.bruteForcePairs = CountBruteForcePairs();
+}
+
+const BroadphaseProxy &SpatialHash::GetProxy(int proxy) const {
+    return proxies[proxy];
+}
+
+int SpatialHash::CountBruteForcePairs() {
+    // number of pairs an all-against-all loop with the same masks would have tested
+    groups.clear();
+    for(const BroadphaseProxy &proxy : proxies) {
+        bool found = false;
+        for(std::pair<BroadphaseProxy, int> &group : groups) {
+            if(group.first.layer == proxy.layer && group.first.mask == proxy.mask) {
+                group.second++;
+                found = true;
+                break;
+            }
+        }
+        if(!found) {
+            groups.push_back(std::make_pair(proxy, 1));
+        }
+    }
+    int total = 0;
+    for(size_t i = 0; i < groups.size(); i++) {
+        if(Accepts(groups[i].first, groups[i].first)) {
+            total += groups[i].second * (groups[i].second - 1) / 2;
+        }
+        for(size_t j = i + 1; j < groups.size(); j++) {
+            if(Accepts(groups[i].first, groups[j].first)) {
+                total += groups[i].second * groups[j].second;
+            }
+        }
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+class JobSystem;
+
+// cells handed to one job when the pair search is split across threads
+#define BROADPHASE_CELL_GRAIN 64
+
+enum CollisionLayer {
+    LAYER_PLAYER = 1 << 0,
+    LAYER_BULLET = 1 << 1,
+    LAYER_ASTEROID = 1 << 2
+};
+
+struct BroadphaseProxy {
+    int index;
+    unsigned int layer;
+    unsigned int mask;
+};
+
+struct BroadphaseStats {
+    int proxies;
+    int cellEntries;
+    int candidatePairs;
+    int bruteForcePairs;
+};
+
+// Uniform grid hashed into a flat list of (cell, proxy) entries. Entries are
+// sorted by cell every frame, so proxies sharing a cell end up adjacent and no
+// per-cell buckets have to be allocated.
+class SpatialHash {
+    public:
+        SpatialHash();
+        SpatialHash(float cellSize);
+
+        void Clear();
+        int Insert(int index, unsigned int layer, unsigned int mask, float minX, float minY, float maxX, float maxY);
+        // Fills pairs with proxy ids (first < second) whose cells overlap and whose masks accept each other.
+        // With jobs, cells are searched in parallel; the result is the same sorted list either way.
+        void FindPairs(std::vector<std::pair<int, int>> &pairs, JobSystem *jobs = nullptr);
+
+        const BroadphaseProxy &GetProxy(int proxy) const;
+
+        float cellSize;
+        BroadphaseStats stats;
+
+    private:
+
+        struct CellEntry {
+            unsigned int cell;
+            int proxy;
+            bool operator<(const CellEntry &other) const;
+        };
+
+        bool Accepts(const BroadphaseProxy &a, const BroadphaseProxy &b) const;
+        void PairsInCells(int firstCell, int lastCell, std::vector<std::pair<int, int>> &pairs) const;
+        int CountBruteForcePairs();
+
+        std::vector<BroadphaseProxy> proxies;
+        std::vector<CellEntry> entries;
+        // index of each cell's first entry in entries, plus the end
+        std::vector<int> cellStarts;
+        // pairs found by each job, concatenated in job order
+        std::vector<std::vector<std::pair<int, int>>> chunkPairs;
+        std::vector<std::pair<BroadphaseProxy, int>> groups;
+};
@@ -0,0 +1,315 @@
+#include "Collision.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SAT_BATCH_SIMD 1
+#endif
+
+// pairs with more axes than this between them take the scalar path
+#define SAT_BATCH_MAX_AXES 16
+
+static void ProjectHull(HullSpan hull, float normalX, float normalY, float &minimum, float &maximum) {
+    minimum = hull.points[0] * normalX + hull.points[1] * normalY;
+    maximum = minimum;
+    for(int i = 1; i < hull.count; i++) {
+        float projected = hull.points[i*2] * normalX + hull.points[i*2+1] * normalY;
+        minimum = fminf(minimum, projected);
+        maximum = fmaxf(maximum, projected);
+    }
+}
+
+static bool TestAxis(float normalX, float normalY, HullSpan first, HullSpan second, float &penetrationX, float &penetrationY) {
+    float firstMin, firstMax, secondMin, secondMax;
+    ProjectHull(first, normalX, normalY, firstMin, firstMax);
+    ProjectHull(second, normalX, normalY, secondMin, secondMax);
+
+    float firstWidth = firstMax - firstMin;
+    float secondWidth = secondMax - secondMin;
+    float distance = fabsf((firstMin + firstWidth / 2.0f) - (secondMin + secondWidth / 2.0f));
+    if(distance - (firstWidth + secondWidth) / 2.0f >= 0.0f) {
+        return false;
+    }
+
+    float amount = fminf(firstMax - secondMin, secondMax - firstMin);
+    penetrationX = normalX * amount;
+    penetrationY = normalY * amount;
+    return true;
+}
+
+static bool TestEdgeSeparation(float edgeX, float edgeY, HullSpan first, HullSpan second, float &penetrationX, float &penetrationY) {
+    float normalX = -edgeY;
+    float normalY = edgeX;
+    float length = sqrtf(normalX*normalX + normalY*normalY);
+    return TestAxis(normalX / length, normalY / length, first, second, penetrationX, penetrationY);
+}
+
+static bool TestHullEdges(HullSpan edges, HullSpan first, HullSpan second, float &bestX, float &bestY, float &bestLength) {
+    for(int i = 0; i < edges.count; i++) {
+        int next = (i + 1) % edges.count;
+        float edgeX = edges.points[next*2] - edges.points[i*2];
+        float edgeY = edges.points[next*2+1] - edges.points[i*2+1];
+        float penetrationX, penetrationY;
+        if(!TestEdgeSeparation(edgeX, edgeY, first, second, penetrationX, penetrationY)) {
+            return false;
+        }
+        float length = penetrationX*penetrationX + penetrationY*penetrationY;
+        if(length < bestLength) {
+            bestLength = length;
+            bestX = penetrationX;
+            bestY = penetrationY;
+        }
+    }
+    return true;
+}
+
+// Returns the index of the first separating axis, or -1 when none of them separate.
+static int TestAxes(AxisSpan axes, HullSpan first, HullSpan second, float &bestX, float &bestY, float &bestLength) {
+    for(int i = 0; i < axes.count; i++) {
+        float penetrationX, penetrationY;
+        if(!TestAxis(axes.axes[i*2], axes.axes[i*2+1], first, second, penetrationX, penetrationY)) {
+            return i;
+        }
+        float length = penetrationX*penetrationX + penetrationY*penetrationY;
+        if(length < bestLength) {
+            bestLength = length;
+            bestX = penetrationX;
+            bestY = penetrationY;
+        }
+    }
+    return -1;
+}
+
+static void HullCenter(HullSpan hull, float &centerX, float &centerY) {
+    centerX = 0.0f;
+    centerY = 0.0f;
+    for(int i = 0; i < hull.count; i++) {
+        centerX += hull.points[i*2];
+        centerY += hull.points[i*2+1];
+    }
+    centerX /= (float)hull.count;
+    centerY /= (float)hull.count;
+}
+
+static void ResolvePenetration(HullSpan first, HullSpan second, float bestX, float bestY, std::pair<float, float> &penetration) {
+    float firstX, firstY, secondX, secondY;
+    HullCenter(first, firstX, firstY);
+    HullCenter(second, secondX, secondY);
+    if(bestX * (firstX - secondX) + bestY * (firstY - secondY) < 0.0f) {
+        bestX = -bestX;
+        bestY = -bestY;
+    }
+    penetration.first = bestX;
+    penetration.second = bestY;
+}
+
+bool CheckSATCollision(HullSpan first, HullSpan second, std::pair<float, float> &penetration) {
+    float bestX = 0.0f;
+    float bestY = 0.0f;
+    float bestLength = INFINITY;
+    if(!TestHullEdges(first, first, second, bestX, bestY, bestLength)) {
+        return false;
+    }
+    if(!TestHullEdges(second, first, second, bestX, bestY, bestLength)) {
+        return false;
+    }
+    ResolvePenetration(first, second, bestX, bestY, penetration);
+    return true;
+}
+
+static bool CheckSATAxes(HullSpan first, AxisSpan firstAxes, HullSpan second, AxisSpan secondAxes, std::pair<float, float> &penetration, int &separatingAxis) {
+    float bestX = 0.0f;
+    float bestY = 0.0f;
+    float bestLength = INFINITY;
+    separatingAxis = TestAxes(firstAxes, first, second, bestX, bestY, bestLength);
+    if(separatingAxis >= 0) {
+        return false;
+    }
+    separatingAxis = TestAxes(secondAxes, first, second, bestX, bestY, bestLength);
+    if(separatingAxis >= 0) {
+        separatingAxis += firstAxes.count;
+        return false;
+    }
+    ResolvePenetration(first, second, bestX, bestY, penetration);
+    return true;
+}
+
+bool CheckSATCollision(HullSpan first, AxisSpan firstAxes, HullSpan second, AxisSpan secondAxes, std::pair<float, float> &penetration) {
+    int separatingAxis;
+    return CheckSATAxes(first, firstAxes, second, secondAxes, penetration, separatingAxis);
+}
+
+bool SeparatesOnAxis(const SATPair &pair, int axis) {
+    const float *normal;
+    if(axis < 0) {
+        return false;
+    } else if(axis < pair.firstAxes.count) {
+        normal = pair.firstAxes.axes + axis*2;
+    } else if(axis < pair.firstAxes.count + pair.secondAxes.count) {
+        normal = pair.secondAxes.axes + (axis - pair.firstAxes.count)*2;
+    } else {
+        return false;
+    }
+    float penetrationX, penetrationY;
+    return !TestAxis(normal[0], normal[1], pair.first, pair.second, penetrationX, penetrationY);
+}
+
+// opposite normals separate along the same line, so only one of them is kept
+static bool HasParallelAxis(const std::vector<float> &axes, size_t start, float normalX, float normalY) {
+    for(size_t i = start; i < axes.size(); i += 2) {
+        if(fabsf(axes[i] * normalY - axes[i+1] * normalX) < 1e-5f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AddAxis(std::vector<float> &axes, size_t start, float normalX, float normalY) {
+    float length = sqrtf(normalX*normalX + normalY*normalY);
+    if(length == 0.0f) {
+        return;
+    }
+    normalX /= length;
+    normalY /= length;
+    if(!HasParallelAxis(axes, start, normalX, normalY)) {
+        axes.push_back(normalX);
+        axes.push_back(normalY);
+    }
+}
+
+int BuildHullAxes(const float *points, int count, std::vector<float> &axes) {
+    size_t start = axes.size();
+    for(int i = 0; i < count; i++) {
+        int next = (i + 1) % count;
+        float edgeX = points[next*2] - points[i*2];
+        float edgeY = points[next*2+1] - points[i*2+1];
+        AddAxis(axes, start, -edgeY, edgeX);
+    }
+    return (int)(axes.size() - start) / 2;
+}
+
+int ScaleHullAxes(const float *axes, int count, float scaleX, float scaleY, std::vector<float> &scaled) {
+    // normals transform by the inverse transpose, which for a scale is the reciprocal scale
+    size_t start = scaled.size();
+    for(int i = 0; i < count; i++) {
+        AddAxis(scaled, start, axes[i*2] / scaleX, axes[i*2+1] / scaleY);
+    }
+    return (int)(scaled.size() - start) / 2;
+}
+
+void RotateHullAxes(const float *axes, int count, float angle, float *out) {
+    float c = cosf(angle);
+    float s = sinf(angle);
+    for(int i = 0; i < count; i++) {
+        float x = axes[i*2];
+        float y = axes[i*2+1];
+        out[i*2] = x * c - y * s;
+        out[i*2+1] = x * s + y * c;
+    }
+}
+
+void CheckSATBatchScalar(const SATPair *pairs, int count, unsigned char *hits, std::pair<float, float> *penetrations, int *separatingAxes) {
+    for(int i = 0; i < count; i++) {
+        const SATPair &pair = pairs[i];
+        hits[i] = CheckSATAxes(pair.first, pair.firstAxes, pair.second, pair.secondAxes, penetrations[i], separatingAxes[i]) ? 1 : 0;
+    }
+}
+
+#ifdef SAT_BATCH_SIMD
+
+static void ProjectHull4(HullSpan hull, __m128 normalX, __m128 normalY, __m128 &minimum, __m128 &maximum) {
+    minimum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(hull.points[0]), normalX), _mm_mul_ps(_mm_set1_ps(hull.points[1]), normalY));
+    maximum = minimum;
+    for(int i = 1; i < hull.count; i++) {
+        __m128 projected = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(hull.points[i*2]), normalX), _mm_mul_ps(_mm_set1_ps(hull.points[i*2+1]), normalY));
+        minimum = _mm_min_ps(minimum, projected);
+        maximum = _mm_max_ps(maximum, projected);
+    }
+}
+
+static bool CheckSATPair4(const SATPair &pair, std::pair<float, float> &penetration, int &separatingAxis) {
+    int axisCount = pair.firstAxes.count + pair.secondAxes.count;
+    if(axisCount == 0 || axisCount > SAT_BATCH_MAX_AXES) {
+        return CheckSATAxes(pair.first, pair.firstAxes, pair.second, pair.secondAxes, penetration, separatingAxis);
+    }
+
+    // axes split into x and y columns, padded to a multiple of four by repeating
+    // the last one; a repeated axis never wins the strict minimum below
+    alignas(16) float axisX[SAT_BATCH_MAX_AXES];
+    alignas(16) float axisY[SAT_BATCH_MAX_AXES];
+    for(int i = 0; i < pair.firstAxes.count; i++) {
+        axisX[i] = pair.firstAxes.axes[i*2];
+        axisY[i] = pair.firstAxes.axes[i*2+1];
+    }
+    for(int i = 0; i < pair.secondAxes.count; i++) {
+        axisX[pair.firstAxes.count + i] = pair.secondAxes.axes[i*2];
+        axisY[pair.firstAxes.count + i] = pair.secondAxes.axes[i*2+1];
+    }
+    int padded = (axisCount + 3) & ~3;
+    for(int i = axisCount; i < padded; i++) {
+        axisX[i] = axisX[axisCount - 1];
+        axisY[i] = axisY[axisCount - 1];
+    }
+
+    // same operations as TestAxis, in the same order, so the lanes round identically
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    alignas(16) float amountX[SAT_BATCH_MAX_AXES];
+    alignas(16) float amountY[SAT_BATCH_MAX_AXES];
+    for(int group = 0; group < padded; group += 4) {
+        __m128 normalX = _mm_load_ps(axisX + group);
+        __m128 normalY = _mm_load_ps(axisY + group);
+        __m128 firstMin, firstMax, secondMin, secondMax;
+        ProjectHull4(pair.first, normalX, normalY, firstMin, firstMax);
+        ProjectHull4(pair.second, normalX, normalY, secondMin, secondMax);
+
+        __m128 firstWidth = _mm_sub_ps(firstMax, firstMin);
+        __m128 secondWidth = _mm_sub_ps(secondMax, secondMin);
+        __m128 distance = _mm_andnot_ps(signBit, _mm_sub_ps(_mm_add_ps(firstMin, _mm_div_ps(firstWidth, two)), _mm_add_ps(secondMin, _mm_div_ps(secondWidth, two))));
+        __m128 gap = _mm_sub_ps(distance, _mm_div_ps(_mm_add_ps(firstWidth, secondWidth), two));
+        int separated = _mm_movemask_ps(_mm_cmpge_ps(gap, zero));
+        if(separated != 0) {
+            // lowest lane first, so padding never shadows the real last axis
+            separatingAxis = group;
+            while(!(separated & 1)) {
+                separated >>= 1;
+                separatingAxis++;
+            }
+            return false;
+        }
+
+        __m128 amount = _mm_min_ps(_mm_sub_ps(firstMax, secondMin), _mm_sub_ps(secondMax, firstMin));
+        _mm_store_ps(amountX + group, _mm_mul_ps(normalX, amount));
+        _mm_store_ps(amountY + group, _mm_mul_ps(normalY, amount));
+    }
+
+    float bestX = 0.0f;
+    float bestY = 0.0f;
+    float bestLength = INFINITY;
+    for(int i = 0; i < axisCount; i++) {
+        float length = amountX[i]*amountX[i] + amountY[i]*amountY[i];
+        if(length < bestLength) {
+            bestLength = length;
+            bestX = amountX[i];
+            bestY = amountY[i];
+        }
+    }
+    separatingAxis = -1;
+    ResolvePenetration(pair.first, pair.second, bestX, bestY, penetration);
+    return true;
+}
+
+void CheckSATBatch(const SATPair *pairs, int count, unsigned char *hits, std::pair<float, float> *penetrations, int *separatingAxes) {
+    for(int i = 0; i < count; i++) {
+        hits[i] = CheckSATPair4(pairs[i], penetrations[i], separatingAxes[i]) ? 1 : 0;
+    }
+}
+
+#else
+
+void CheckSATBatch(const SATPair *pairs, int count, unsigned char *hits, std::pair<float, float> *penetrations, int *separatingAxes) {
+    CheckSATBatchScalar(pairs, count, hits, penetrations, separatingAxes);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// View over a world-space hull stored as packed x, y pairs.
+struct HullSpan {
+    HullSpan() : points(nullptr), count(0) {}
+    HullSpan(const float *points, int count) : points(points), count(count) {}
+    const float *points;
+    int count;
+};
+
+// View over unit separating axes stored as packed x, y pairs.
+struct AxisSpan {
+    AxisSpan() : axes(nullptr), count(0) {}
+    AxisSpan(const float *axes, int count) : axes(axes), count(count) {}
+    const float *axes;
+    int count;
+};
+
+// Unit edge normals of a convex outline, with parallel edges sharing one axis.
+// Returns the number of axes written to axes (two floats each).
+int BuildHullAxes(const float *points, int count, std::vector<float> &axes);
+// Axes of the outline after scaling its points by (scaleX, scaleY), deduplicated again.
+int ScaleHullAxes(const float *axes, int count, float scaleX, float scaleY, std::vector<float> &scaled);
+// Rotates count unit axes by angle radians into out.
+void RotateHullAxes(const float *axes, int count, float angle, float *out);
+
+// Separating axis test between two convex hulls. On overlap, penetration holds the
+// minimum translation that pushes the first hull out of the second.
+bool CheckSATCollision(HullSpan first, HullSpan second, std::pair<float, float> &penetration);
+// Same test using precomputed world-space axes for each hull instead of deriving
+// normals from the edges on every call.
+bool CheckSATCollision(HullSpan first, AxisSpan firstAxes, HullSpan second, AxisSpan secondAxes, std::pair<float, float> &penetration);
+
+// One narrowphase query: the first hull is pushed out of the second.
+struct SATPair {
+    HullSpan first;
+    AxisSpan firstAxes;
+    HullSpan second;
+    AxisSpan secondAxes;
+};
+
+// Tests count pairs at once, projecting both hulls onto four axes per SSE register.
+// hits[i] is 1 when pair i overlaps and penetrations[i] then holds its minimum
+// translation; otherwise separatingAxes[i] is the first axis that separated it,
+// counting the first hull's axes then the second's. Matches CheckSATBatchScalar.
+void CheckSATBatch(const SATPair *pairs, int count, unsigned char *hits, std::pair<float, float> *penetrations, int *separatingAxes);
+// Reference implementation, one scalar test per pair.
+void CheckSATBatchScalar(const SATPair *pairs, int count, unsigned char *hits, std::pair<float, float> *penetrations, int *separatingAxes);
+// True when the axis, numbered as in separatingAxes, separates the pair. Out of
+// range axes never do, so a stale index is only a wasted test.
+bool SeparatesOnAxis(const SATPair &pair, int axis);
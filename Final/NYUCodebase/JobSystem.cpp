@@ -0,0 +1,155 @@
+#include "JobSystem.h"
+
+// idle workers keep looking this many times before going to sleep, since the
+// loops of one frame are queued back to back
+#define JOB_IDLE_SPINS 256
+
+// which pool's worker this thread is, if any; queue 0 belongs to the caller
+static thread_local const JobSystem *workerPool = nullptr;
+static thread_local int workerQueue = 0;
+
+JobSystem::JobSystem(int workers) : running(true), queued(0), jobCount(0), stealCount(0) {
+    if(workers < 0) {
+        workers = 0;
+    }
+    for(int i = 0; i <= workers; i++) {
+        queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+    for(int i = 1; i <= workers; i++) {
+        threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        running = false;
+    }
+    wake.notify_all();
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+int JobSystem::ThreadCount() const {
+    return (int)queues.size();
+}
+
+JobStats JobSystem::Stats() const {
+    JobStats stats;
+    stats.jobs = jobCount.load(std::memory_order_relaxed);
+    stats.steals = stealCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int JobSystem::CurrentQueue() const {
+    return workerPool == this ? workerQueue : 0;
+}
+
+void JobSystem::ParallelFor(int count, int grain, const std::function<void(int, int)> &body) {
+    if(count <= 0) {
+        return;
+    }
+    if(grain < 1) {
+        grain = 1;
+    }
+    int chunks = (count + grain - 1) / grain;
+    if(chunks == 1 || threads.empty()) {
+        for(int begin = 0; begin < count; begin += grain) {
+            body(begin, begin + grain < count ? begin + grain : count);
+        }
+        return;
+    }
+
+    int self = CurrentQueue();
+    std::atomic<int> pending(chunks);
+    {
+        WorkQueue &queue = *queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        // last chunk first, so the owner pops chunk 0 first and thieves start at the far end
+        for(int chunk = chunks - 1; chunk >= 0; chunk--) {
+            Job job;
+            job.body = &body;
+            job.begin = chunk * grain;
+            job.end = job.begin + grain < count ? job.begin + grain : count;
+            job.owner = self;
+            job.pending = &pending;
+            queue.jobs.push_front(job);
+        }
+    }
+    queued.fetch_add(chunks);
+    {
+        // taken so a worker between checking queued and waiting cannot miss this
+        std::lock_guard<std::mutex> guard(sleepLock);
+    }
+    wake.notify_all();
+
+    while(pending.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if(Pop(self, job) || Steal(self, job)) {
+            Run(job, self);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::Pop(int queue, Job &job) {
+    WorkQueue &own = *queues[queue];
+    std::lock_guard<std::mutex> guard(own.lock);
+    if(own.jobs.empty()) {
+        return false;
+    }
+    job = own.jobs.front();
+    own.jobs.pop_front();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::Steal(int thief, Job &job) {
+    int count = (int)queues.size();
+    for(int offset = 1; offset < count; offset++) {
+        WorkQueue &victim = *queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.jobs.empty()) {
+            job = victim.jobs.back();
+            victim.jobs.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Run(const Job &job, int thread) {
+    (*job.body)(job.begin, job.end);
+    jobCount.fetch_add(1, std::memory_order_relaxed);
+    if(job.owner != thread) {
+        stealCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    job.pending->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(int index) {
+    workerPool = this;
+    workerQueue = index;
+    int idle = 0;
+    while(true) {
+        Job job;
+        if(Pop(index, job) || Steal(index, job)) {
+            Run(job, index);
+            idle = 0;
+            continue;
+        }
+        if(++idle < JOB_IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        std::unique_lock<std::mutex> lock(sleepLock);
+        wake.wait(lock, [this] { return !running || queued.load() > 0; });
+        if(!running) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JobStats {
+    int jobs;
+    // jobs run by a thread other than the one that queued them
+    int steals;
+};
+
+// Small work-stealing pool for splitting one frame's loops across cores. Every
+// thread has its own deque: ParallelFor pushes its chunks onto the calling
+// thread's deque and works through them newest first, while idle threads
+// steal from the oldest end. The thread calling ParallelFor always helps, so
+// a pool with no workers simply runs everything inline.
+//
+// Only one thread outside the pool (the simulation thread) may call ParallelFor
+// at a time; jobs themselves may call it again.
+class JobSystem {
+    public:
+        JobSystem(int workers);
+        ~JobSystem();
+
+        // Calls body(begin, end) over [0, count) in chunks of grain items and
+        // returns once all of them have finished. Chunk c always covers
+        // [c * grain, (c + 1) * grain), whichever thread runs it, so bodies can
+        // write per-chunk results indexed by begin / grain and merge them in order.
+        void ParallelFor(int count, int grain, const std::function<void(int, int)> &body);
+
+        // Worker threads plus the calling thread.
+        int ThreadCount() const;
+        JobStats Stats() const;
+
+    private:
+        JobSystem(const JobSystem &);
+        JobSystem &operator=(const JobSystem &);
+
+        struct Job {
+            const std::function<void(int, int)> *body;
+            int begin;
+            int end;
+            int owner;
+            std::atomic<int> *pending;
+        };
+
+        struct WorkQueue {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+
+        void WorkerLoop(int index);
+        bool Pop(int queue, Job &job);
+        bool Steal(int thief, Job &job);
+        void Run(const Job &job, int thread);
+        int CurrentQueue() const;
+
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<bool> running;
+        // jobs sitting in any deque; workers sleep while it is zero
+        std::atomic<int> queued;
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        std::atomic<int> jobCount;
+        std::atomic<int> stealCount;
+};
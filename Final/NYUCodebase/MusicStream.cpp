@@ -0,0 +1,221 @@
+#include "MusicStream.h"
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+MusicStream::MusicStream() : type(MUS_NONE), loops(0), startTime(0), running(false), prefetchFile(NULL), stream(NULL), missFile(NULL),
+    position(0), fileSize(0), music(NULL), openMicros(-1), firstChunkMicros(-1), playingMicros(-1), bytesPrefetched(0), bytesMissed(0) {
+    staging.resize(MUSIC_CHUNK_BYTES);
+    for(int i = 0; i < MUSIC_CHUNKS; i++) {
+        chunks[i].index = -1;
+        chunks[i].length = 0;
+        chunks[i].data.resize(MUSIC_CHUNK_BYTES);
+    }
+}
+
+MusicStream::~MusicStream() {
+    Stop();
+}
+
+void MusicStream::Start(const std::string &fileName, Mix_MusicType type, int loops) {
+    if(loader.joinable()) {
+        return;
+    }
+    this->fileName = fileName;
+    this->type = type;
+    this->loops = loops;
+    startTime = SDL_GetPerformanceCounter();
+    running = true;
+    loader = std::thread(&MusicStream::LoaderLoop, this);
+}
+
+void MusicStream::Stop() {
+    if(!loader.joinable()) {
+        return;
+    }
+    running = false;
+    loader.join();
+    if(music) {
+        Mix_HaltMusic();
+        Mix_FreeMusic(music);
+        music = NULL;
+    }
+    if(stream) {
+        SDL_FreeRW(stream);
+        stream = NULL;
+    }
+    if(prefetchFile) {
+        SDL_RWclose(prefetchFile);
+        prefetchFile = NULL;
+    }
+    if(missFile) {
+        SDL_RWclose(missFile);
+        missFile = NULL;
+    }
+}
+
+int MusicStream::Elapsed() const {
+    return (int)((SDL_GetPerformanceCounter() - startTime) * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+
+MusicStats MusicStream::Stats() const {
+    MusicStats stats;
+    stats.openMicros = openMicros;
+    stats.firstChunkMicros = firstChunkMicros;
+    stats.playingMicros = playingMicros;
+    stats.bytesPrefetched = bytesPrefetched;
+    stats.bytesMissed = bytesMissed;
+    return stats;
+}
+
+void MusicStream::LoaderLoop() {
+    prefetchFile = SDL_RWFromFile(fileName.c_str(), "rb");
+    if(!prefetchFile) {
+        std::cout << "Unable to open music " << fileName << ": " << SDL_GetError() << "\n";
+        return;
+    }
+    fileSize = SDL_RWsize(prefetchFile);
+    openMicros = Elapsed();
+    if(!Prefetch(0)) {
+        std::cout << "Unable to read music " << fileName << "\n";
+        return;
+    }
+    firstChunkMicros = Elapsed();
+
+    stream = SDL_AllocRW();
+    stream->size = &MusicStream::RWSize;
+    stream->seek = &MusicStream::RWSeek;
+    stream->read = &MusicStream::RWRead;
+    stream->write = &MusicStream::RWWrite;
+    stream->close = &MusicStream::RWClose;
+    stream->type = 0;
+    stream->hidden.unknown.data1 = this;
+    position = 0;
+    // the decoder reads its headers here, on this thread, before the audio thread takes over
+    music = Mix_LoadMUSType_RW(stream, type, 0);
+    if(!music) {
+        std::cout << "Unable to decode music " << fileName << ": " << Mix_GetError() << "\n";
+        return;
+    }
+    Mix_PlayMusic(music, loops);
+    playingMicros = Elapsed();
+
+    while(running) {
+        // keep the chunk being decoded and the ones right after it in memory
+        long long current = position.load() / MUSIC_CHUNK_BYTES;
+        bool loaded = false;
+        for(long long index = current; index < current + MUSIC_CHUNKS && index * MUSIC_CHUNK_BYTES < fileSize; index++) {
+            bool resident;
+            {
+                std::lock_guard<std::mutex> guard(chunkLock);
+                resident = chunks[index % MUSIC_CHUNKS].index == index;
+            }
+            if(!resident) {
+                Prefetch(index);
+                loaded = true;
+                break;
+            }
+        }
+        if(!loaded) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+}
+
+bool MusicStream::Prefetch(long long index) {
+    // the disk read happens outside the lock; only the buffer swap is inside it
+    SDL_RWseek(prefetchFile, index * MUSIC_CHUNK_BYTES, RW_SEEK_SET);
+    size_t length = SDL_RWread(prefetchFile, staging.data(), 1, MUSIC_CHUNK_BYTES);
+    if(length == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(chunkLock);
+    Chunk &chunk = chunks[index % MUSIC_CHUNKS];
+    chunk.data.swap(staging);
+    chunk.index = index;
+    chunk.length = (int)length;
+    return true;
+}
+
+size_t MusicStream::ReadAt(unsigned char *out, size_t length) {
+    long long offset = position.load();
+    size_t done = 0;
+    while(done < length && offset < fileSize) {
+        long long index = offset / MUSIC_CHUNK_BYTES;
+        int within = (int)(offset % MUSIC_CHUNK_BYTES);
+        size_t wanted = length - done;
+        if(wanted > (size_t)(MUSIC_CHUNK_BYTES - within)) {
+            wanted = MUSIC_CHUNK_BYTES - within;
+        }
+        bool served = false;
+        {
+            std::unique_lock<std::mutex> guard(chunkLock, std::try_to_lock);
+            if(guard.owns_lock()) {
+                const Chunk &chunk = chunks[index % MUSIC_CHUNKS];
+                if(chunk.index == index && within < chunk.length) {
+                    if(wanted > (size_t)(chunk.length - within)) {
+                        wanted = chunk.length - within;
+                    }
+                    memcpy(out + done, chunk.data.data() + within, wanted);
+                    served = true;
+                }
+            }
+        }
+        if(served) {
+            bytesPrefetched += (unsigned int)wanted;
+        } else {
+            if(!missFile) {
+                missFile = SDL_RWFromFile(fileName.c_str(), "rb");
+                if(!missFile) {
+                    break;
+                }
+            }
+            SDL_RWseek(missFile, offset, RW_SEEK_SET);
+            wanted = SDL_RWread(missFile, out + done, 1, wanted);
+            if(wanted == 0) {
+                break;
+            }
+            bytesMissed += (unsigned int)wanted;
+        }
+        done += wanted;
+        offset += wanted;
+        position = offset;
+    }
+    return done;
+}
+
+Sint64 MusicStream::RWSize(SDL_RWops *context) {
+    return ((MusicStream *)context->hidden.unknown.data1)->fileSize;
+}
+
+Sint64 MusicStream::RWSeek(SDL_RWops *context, Sint64 offset, int whence) {
+    MusicStream *self = (MusicStream *)context->hidden.unknown.data1;
+    Sint64 target = offset;
+    if(whence == RW_SEEK_CUR) {
+        target += self->position.load();
+    } else if(whence == RW_SEEK_END) {
+        target += self->fileSize;
+    }
+    if(target < 0) {
+        return -1;
+    }
+    self->position = target;
+    return target;
+}
+
+size_t MusicStream::RWRead(SDL_RWops *context, void *pointer, size_t size, size_t count) {
+    if(size == 0) {
+        return 0;
+    }
+    MusicStream *self = (MusicStream *)context->hidden.unknown.data1;
+    return self->ReadAt((unsigned char *)pointer, size * count) / size;
+}
+
+size_t MusicStream::RWWrite(SDL_RWops *context, const void *pointer, size_t size, size_t count) {
+    return 0;
+}
+
+int MusicStream::RWClose(SDL_RWops *context) {
+    // freed by Stop(), which owns it
+    return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+// bytes read from disk at a time
+#define MUSIC_CHUNK_BYTES (64 * 1024)
+// chunks kept in memory; at typical MP3 bitrates this is several seconds ahead
+#define MUSIC_CHUNKS 4
+
+struct MusicStats {
+    // microseconds from Start() until the file was open, the first chunk was
+    // in memory and the track was playing; -1 until it happens
+    int openMicros;
+    int firstChunkMicros;
+    int playingMicros;
+    // decoder reads served from the prefetched chunks, and the ones that had
+    // to go to disk themselves (seeks, loop restarts, prefetch falling behind)
+    unsigned int bytesPrefetched;
+    unsigned int bytesMissed;
+};
+
+// Background music that never loads on the main thread. Start() returns at
+// once; a loader thread opens the file, reads its first chunk, hands SDL_mixer
+// an SDL_RWops that reads through a ring of MUSIC_CHUNKS fixed-size chunks
+// and starts the track, then keeps the chunks just ahead of the decoder
+// filled. SDL_mixer still does the decoding, on its audio thread, so memory
+// stays at the ring however long the track is.
+class MusicStream {
+    public:
+        MusicStream();
+        ~MusicStream();
+
+        void Start(const std::string &fileName, Mix_MusicType type, int loops);
+        // Halts the track and releases the file; safe to call more than once.
+        void Stop();
+
+        MusicStats Stats() const;
+
+    private:
+        MusicStream(const MusicStream &);
+        MusicStream &operator=(const MusicStream &);
+
+        struct Chunk {
+            // chunk number in the file, or -1 while empty
+            long long index;
+            int length;
+            std::vector<unsigned char> data;
+        };
+
+        void LoaderLoop();
+        bool Prefetch(long long index);
+        size_t ReadAt(unsigned char *out, size_t length);
+        int Elapsed() const;
+
+        static Sint64 RWSize(SDL_RWops *context);
+        static Sint64 RWSeek(SDL_RWops *context, Sint64 offset, int whence);
+        static size_t RWRead(SDL_RWops *context, void *pointer, size_t size, size_t count);
+        static size_t RWWrite(SDL_RWops *context, const void *pointer, size_t size, size_t count);
+        static int RWClose(SDL_RWops *context);
+
+        std::string fileName;
+        Mix_MusicType type;
+        int loops;
+        Uint64 startTime;
+
+        std::thread loader;
+        std::atomic<bool> running;
+        // loader thread only
+        SDL_RWops *prefetchFile;
+        std::vector<unsigned char> staging;
+
+        // Chunk contents are swapped in by the loader and copied out by the
+        // decoder under chunkLock, each hold lasting one memcpy. The decoder
+        // only ever try-locks and reads the disk itself on failure, so the
+        // audio thread never waits on the loader.
+        std::mutex chunkLock;
+        Chunk chunks[MUSIC_CHUNKS];
+
+        // decoder side: wherever SDL_mixer last read or seeked to
+        SDL_RWops *stream;
+        SDL_RWops *missFile;
+        std::atomic<long long> position;
+        long long fileSize;
+        Mix_Music *music;
+
+        std::atomic<int> openMicros;
+        std::atomic<int> firstChunkMicros;
+        std::atomic<int> playingMicros;
+        std::atomic<unsigned int> bytesPrefetched;
+        std::atomic<unsigned int> bytesMissed;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+// Refers to a pooled object. The generation changes every time its slot is
+// released, so a handle to a recycled object is detected instead of aliasing
+// whatever took its place.
+struct PoolHandle {
+    PoolHandle() : slot(0xFFFFFFFF), generation(0) {}
+    PoolHandle(unsigned int slot, unsigned int generation) : slot(slot), generation(generation) {}
+    bool operator==(const PoolHandle &other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const PoolHandle &other) const { return !(*this == other); }
+    unsigned int slot;
+    unsigned int generation;
+};
+
+// Fixed-capacity pool that keeps its live objects packed at the front of one
+// array. Acquire and Release are O(1); Release moves the last live object into
+// the hole, so dense indices (and references) are only stable until the next
+// Release.
+template <typename T>
+class ObjectPool {
+    public:
+        ObjectPool() {}
+        explicit ObjectPool(unsigned int capacity) {
+            items.reserve(capacity);
+            denseToSlot.reserve(capacity);
+            slots.resize(capacity);
+            freeSlots.reserve(capacity);
+            for(unsigned int i = capacity; i > 0; i--) {
+                slots[i-1].dense = 0;
+                slots[i-1].generation = 0;
+                freeSlots.push_back(i-1);
+            }
+        }
+
+        // Returns an invalid handle when the pool is full.
+        PoolHandle Acquire(const T &value) {
+            if(freeSlots.empty()) {
+                return PoolHandle();
+            }
+            unsigned int slot = freeSlots.back();
+            freeSlots.pop_back();
+            slots[slot].dense = (unsigned int)items.size();
+            items.push_back(value);
+            denseToSlot.push_back(slot);
+            return PoolHandle(slot, slots[slot].generation);
+        }
+
+        bool Release(PoolHandle handle) {
+            if(!IsAlive(handle)) {
+                return false;
+            }
+            ReleaseAt(slots[handle.slot].dense);
+            return true;
+        }
+
+        void ReleaseAt(unsigned int dense) {
+            unsigned int slot = denseToSlot[dense];
+            unsigned int last = (unsigned int)items.size() - 1;
+            if(dense != last) {
+                items[dense] = items[last];
+                denseToSlot[dense] = denseToSlot[last];
+                slots[denseToSlot[dense]].dense = dense;
+            }
+            items.pop_back();
+            denseToSlot.pop_back();
+            slots[slot].generation++;
+            freeSlots.push_back(slot);
+        }
+
+        bool IsAlive(PoolHandle handle) const {
+            return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+        }
+
+        T *Get(PoolHandle handle) {
+            return IsAlive(handle) ? &items[slots[handle.slot].dense] : nullptr;
+        }
+
+        PoolHandle HandleAt(unsigned int dense) const {
+            unsigned int slot = denseToSlot[dense];
+            return PoolHandle(slot, slots[slot].generation);
+        }
+
+        void Clear() {
+            while(!items.empty()) {
+                ReleaseAt((unsigned int)items.size() - 1);
+            }
+        }
+
+        unsigned int Size() const { return (unsigned int)items.size(); }
+        unsigned int Capacity() const { return (unsigned int)slots.size(); }
+        bool Full() const { return freeSlots.empty(); }
+
+        T &operator[](unsigned int dense) { return items[dense]; }
+        const T &operator[](unsigned int dense) const { return items[dense]; }
+
+        typename std::vector<T>::iterator begin() { return items.begin(); }
+        typename std::vector<T>::iterator end() { return items.end(); }
+        typename std::vector<T>::const_iterator begin() const { return items.begin(); }
+        typename std::vector<T>::const_iterator end() const { return items.end(); }
+
+    private:
+        struct Slot {
+            unsigned int dense;
+            unsigned int generation;
+        };
+
+        std::vector<T> items;
+        std::vector<unsigned int> denseToSlot;
+        std::vector<Slot> slots;
+        std::vector<unsigned int> freeSlots;
+};
@@ -0,0 +1,387 @@
+#include "ParticleEmitter.h"
+#include "Utilities.h"
+#include "JobSystem.h"
+#include <math.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+bool ParticleProgram::Load(const char* vertexShaderFile, const char* fragmentShaderFile) {
+    linked = program.Load(vertexShaderFile, fragmentShaderFile);
+    FindLocations();
+    return linked;
+}
+
+bool ParticleProgram::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
+    linked = program.LoadFromSource(vertexSource, fragmentSource);
+    FindLocations();
+    return linked;
+}
+
+void ParticleProgram::FindLocations() {
+    velocityAttribute = glGetAttribLocation(program.programID, "velocity");
+    ageAttribute = glGetAttribLocation(program.programID, "age");
+    originUniform = glGetUniformLocation(program.programID, "origin");
+    timeUniform = glGetUniformLocation(program.programID, "time");
+    maxLifetimeUniform = glGetUniformLocation(program.programID, "maxLifetime");
+    startColorUniform = glGetUniformLocation(program.programID, "startColor");
+    endColorUniform = glGetUniformLocation(program.programID, "endColor");
+}
+
+ParticleEmitter::ParticleEmitter() : enable(false), maxLifetime(0.0f), emitterLife(-1.0f), timer(0.0f), count(0), stepElapsed(0.0f), vbo(0), vboSize(0), spawnVbo(0) {
+    matrix = glm::mat4(1.0f);
+    gpuEvaluated = false;
+    gpuTime = 0.0f;
+    previousGpuTime = 0.0f;
+}
+
+ParticleEmitter::ParticleEmitter(glm::vec3 position, float particleLife, unsigned int particleAmount)
+: position(position), maxLifetime(particleLife), emitterLife(-1.0f), timer(0.0f), startColor(1.0f, 1.0f, 1.0f, 1.0f), endColor(0.0f, 0.0f, 0.0f, 0.0f), vbo(0), vboSize(0), spawnVbo(0) {
+    matrix = glm::mat4(1.0f);
+    Spawn(particleAmount);
+    enable = true;
+    gpuEvaluated = false;
+    gpuTime = 0.0f;
+    previousGpuTime = 0.0f;
+}
+
+ParticleEmitter::ParticleEmitter(glm::vec3 position, float emitterLife, float particleLife, unsigned int particleAmount, glm::vec4 startColor, glm::vec4 endColor)
+: position(position), maxLifetime(particleLife), emitterLife(emitterLife), timer(0.0f), startColor(startColor), endColor(endColor), vbo(0), vboSize(0), spawnVbo(0) {
+    matrix = glm::mat4(1.0f);
+    Spawn(particleAmount);
+    enable = true;
+    gpuEvaluated = false;
+    gpuTime = 0.0f;
+    previousGpuTime = 0.0f;
+}
+
+ParticleEmitter::ParticleEmitter(const ParticleEmitter& other) : vbo(0), vboSize(0), spawnVbo(0) {
+    CopyFrom(other);
+}
+
+ParticleEmitter& ParticleEmitter::operator=(const ParticleEmitter& other) {
+    if(this != &other) {
+        CopyFrom(other);
+    }
+    return *this;
+}
+
+ParticleEmitter::~ParticleEmitter() {
+    if(vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+    }
+    if(spawnVbo != 0) {
+        glDeleteBuffers(1, &spawnVbo);
+    }
+}
+
+void ParticleEmitter::CopyFrom(const ParticleEmitter& other) {
+    enable = other.enable;
+    position = other.position;
+    matrix = other.matrix;
+    maxLifetime = other.maxLifetime;
+    emitterLife = other.emitterLife;
+    timer = other.timer;
+    startColor = other.startColor;
+    endColor = other.endColor;
+    count = other.count;
+    x = other.x;
+    y = other.y;
+    vx = other.vx;
+    vy = other.vy;
+    life = other.life;
+    previousX = other.previousX;
+    previousY = other.previousY;
+    stepElapsed = other.stepElapsed;
+    gpuEvaluated = other.gpuEvaluated;
+    gpuTime = other.gpuTime;
+    previousGpuTime = other.previousGpuTime;
+}
+
+void ParticleEmitter::CopyClockFrom(const ParticleEmitter& other) {
+    enable = other.enable;
+    position = other.position;
+    matrix = other.matrix;
+    timer = other.timer;
+    gpuTime = other.gpuTime;
+    previousGpuTime = other.previousGpuTime;
+}
+
+void ParticleEmitter::Spawn(unsigned int particleAmount) {
+    count = particleAmount;
+    unsigned int size = (particleAmount + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+    x.assign(size, position.x);
+    y.assign(size, position.y);
+    vx.assign(size, 0.0f);
+    vy.assign(size, 0.0f);
+    life.assign(size, 0.0f);
+    for(unsigned int i = 0; i < particleAmount; i++) {
+        vx[i] = genRandom(-1, 1);
+        vy[i] = genRandom(-1, 1);
+        life[i] = genRandom(0, maxLifetime);
+    }
+    previousX = x;
+    previousY = y;
+    stepElapsed = 0.0f;
+}
+
+void ParticleEmitter::Restart(glm::vec3 newPosition) {
+    position = newPosition;
+    timer = 0.0f;
+    gpuTime = 0.0f;
+    previousGpuTime = 0.0f;
+    enable = true;
+    Spawn(count);
+    if(spawnVbo != 0) {
+        glDeleteBuffers(1, &spawnVbo);
+        spawnVbo = 0;
+    }
+}
+
+void ParticleEmitter::Update(float elapsed, JobSystem* jobs) {
+    timer += elapsed;
+    if(timer > emitterLife && emitterLife != -1.0f) {
+        enable = false;
+    }
+    if(gpuEvaluated) {
+        // wrapped so the shader's mod() keeps full precision over long sessions
+        previousGpuTime = gpuTime;
+        gpuTime = fmodf(gpuTime + elapsed, maxLifetime);
+        return;
+    }
+    matrix = glm::mat4(1.0f);
+    // same sizes every step, so these copies never allocate
+    previousX = x;
+    previousY = y;
+    stepElapsed = elapsed;
+    if(jobs && x.size() > PARTICLE_JOB_GRAIN) {
+        jobs->ParallelFor((int)x.size(), PARTICLE_JOB_GRAIN, [this, elapsed](int begin, int end) {
+            UpdateParticles(x.data() + begin, y.data() + begin, vx.data() + begin, vy.data() + begin, life.data() + begin,
+                            (unsigned int)(end - begin), position.x, position.y, maxLifetime, elapsed);
+        });
+        return;
+    }
+    UpdateParticles(x.data(), y.data(), vx.data(), vy.data(), life.data(), (unsigned int)x.size(),
+                    position.x, position.y, maxLifetime, elapsed);
+}
+
+void ParticleEmitter::Render(ShaderProgram& program, float alpha) {
+    program.SetModelMatrix(matrix);
+    bool hasColor = program.colorAttribute != (GLuint)-1;
+    int stride = hasColor ? 6 : 2;
+    vertexData.resize(count * stride);
+    float* out = vertexData.data();
+    for(unsigned int i = 0; i < count; i++) {
+        // a particle that respawned during the last Update is drawn where it is now
+        if(life[i] <= stepElapsed) {
+            out[0] = x[i];
+            out[1] = y[i];
+        } else {
+            out[0] = lerp(previousX[i], x[i], alpha);
+            out[1] = lerp(previousY[i], y[i], alpha);
+        }
+        if(hasColor) {
+            float relativeLifetime = (life[i]/maxLifetime);
+            out[2] = lerp(startColor.r, endColor.r, relativeLifetime);
+            out[3] = lerp(startColor.g, endColor.g, relativeLifetime);
+            out[4] = lerp(startColor.b, endColor.b, relativeLifetime);
+            out[5] = lerp(startColor.a, endColor.a, relativeLifetime);
+        }
+        out += stride;
+    }
+
+    if(vbo == 0) {
+        glGenBuffers(1, &vbo);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLsizeiptr size = (GLsizeiptr)(vertexData.size() * sizeof(float));
+    // orphan the previous frame's storage so the driver never stalls on a buffer still being drawn
+    if(size > vboSize) {
+        vboSize = size;
+    }
+    glBufferData(GL_ARRAY_BUFFER, vboSize, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertexData.data());
+
+    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, stride * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(program.positionAttribute);
+    if(hasColor) {
+        glVertexAttribPointer(program.colorAttribute, 4, GL_FLOAT, false, stride * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(program.colorAttribute);
+    }
+    glDrawArrays(GL_POINTS, 0, count);
+    glDisableVertexAttribArray(program.positionAttribute);
+    if(hasColor) {
+        glDisableVertexAttribArray(program.colorAttribute);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleEmitter::RenderGPU(ParticleProgram& particleProgram, float alpha) {
+    ShaderProgram& program = particleProgram.program;
+    program.SetModelMatrix(matrix);
+    if(spawnVbo == 0) {
+        std::vector<float> spawnData(count * 3);
+        for(unsigned int i = 0; i < count; i++) {
+            spawnData[i*3] = vx[i];
+            spawnData[i*3+1] = vy[i];
+            spawnData[i*3+2] = life[i];
+        }
+        glGenBuffers(1, &spawnVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, spawnVbo);
+        glBufferData(GL_ARRAY_BUFFER, spawnData.size() * sizeof(float), spawnData.data(), GL_STATIC_DRAW);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, spawnVbo);
+    }
+    glUniform2f(particleProgram.originUniform, position.x, position.y);
+    // unwrap across the fmodf in Update before blending
+    float time = gpuTime < previousGpuTime ? gpuTime + maxLifetime : gpuTime;
+    glUniform1f(particleProgram.timeUniform, fmodf(lerp(previousGpuTime, time, alpha), maxLifetime));
+    glUniform1f(particleProgram.maxLifetimeUniform, maxLifetime);
+    glUniform4f(particleProgram.startColorUniform, startColor.r, startColor.g, startColor.b, startColor.a);
+    glUniform4f(particleProgram.endColorUniform, endColor.r, endColor.g, endColor.b, endColor.a);
+
+    glVertexAttribPointer(particleProgram.velocityAttribute, 2, GL_FLOAT, false, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(particleProgram.velocityAttribute);
+    glVertexAttribPointer(particleProgram.ageAttribute, 1, GL_FLOAT, false, 3 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(particleProgram.ageAttribute);
+    glDrawArrays(GL_POINTS, 0, count);
+    glDisableVertexAttribArray(particleProgram.velocityAttribute);
+    glDisableVertexAttribArray(particleProgram.ageAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+EmitterPool::EmitterPool() : dropped(0) {}
+
+EmitterPool::EmitterPool(unsigned int capacity, float emitterLife, float particleLife, unsigned int particleAmount, glm::vec4 startColor, glm::vec4 endColor) : dropped(0) {
+    ParticleEmitter prototype(glm::vec3(0.0f, 0.0f, 0.0f), emitterLife, particleLife, particleAmount, startColor, endColor);
+    prototype.enable = false;
+    emitters = std::vector<ParticleEmitter>(capacity, prototype);
+    freeList.reserve(capacity);
+    active.reserve(capacity);
+    Clear();
+}
+
+void EmitterPool::Emit(glm::vec3 position) {
+    if(emitters.empty()) {
+        return;
+    }
+    unsigned int slot;
+    if(!freeList.empty()) {
+        slot = freeList.back();
+        freeList.pop_back();
+    } else {
+        slot = active.front();
+        active.erase(active.begin());
+        dropped++;
+    }
+    emitters[slot].Restart(position);
+    active.push_back(slot);
+}
+
+void EmitterPool::Update(float elapsed, JobSystem* jobs) {
+    if(jobs) {
+        // emitters share nothing, so only the free list bookkeeping below stays serial
+        jobs->ParallelFor((int)active.size(), EMITTER_JOB_GRAIN, [this, elapsed](int begin, int end) {
+            for(int i = begin; i < end; i++) {
+                emitters[active[i]].Update(elapsed);
+            }
+        });
+    } else {
+        for(size_t i = 0; i < active.size(); i++) {
+            emitters[active[i]].Update(elapsed);
+        }
+    }
+    size_t kept = 0;
+    for(size_t i = 0; i < active.size(); i++) {
+        ParticleEmitter& emitter = emitters[active[i]];
+        if(emitter.enable) {
+            active[kept++] = active[i];
+        } else {
+            freeList.push_back(active[i]);
+        }
+    }
+    active.resize(kept);
+}
+
+void EmitterPool::Render(ShaderProgram& program, float alpha) {
+    for(unsigned int slot : active) {
+        emitters[slot].Render(program, alpha);
+    }
+}
+
+void EmitterPool::Clear() {
+    active.clear();
+    freeList.clear();
+    for(unsigned int i = (unsigned int)emitters.size(); i > 0; i--) {
+        emitters[i-1].enable = false;
+        freeList.push_back(i-1);
+    }
+}
+
+unsigned int EmitterPool::ActiveCount() const {
+    return (unsigned int)active.size();
+}
+
+unsigned int EmitterPool::Capacity() const {
+    return (unsigned int)emitters.size();
+}
+
+void UpdateParticlesScalar(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                           float originX, float originY, float maxLifetime, float elapsed) {
+    for(unsigned int i = 0; i < size; i++) {
+        bool respawn = life[i] > maxLifetime;
+        x[i] = (respawn ? originX : x[i]) + vx[i] * elapsed;
+        y[i] = (respawn ? originY : y[i]) + vy[i] * elapsed;
+        life[i] = (respawn ? 0.0f : life[i]) + elapsed;
+    }
+}
+
+#if defined(__AVX__)
+
+void UpdateParticles(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                     float originX, float originY, float maxLifetime, float elapsed) {
+    const __m256 ox = _mm256_set1_ps(originX);
+    const __m256 oy = _mm256_set1_ps(originY);
+    const __m256 maxLife = _mm256_set1_ps(maxLifetime);
+    const __m256 dt = _mm256_set1_ps(elapsed);
+    for(unsigned int i = 0; i < size; i += 8) {
+        __m256 l = _mm256_loadu_ps(life + i);
+        __m256 respawn = _mm256_cmp_ps(l, maxLife, _CMP_GT_OQ);
+        __m256 px = _mm256_blendv_ps(_mm256_loadu_ps(x + i), ox, respawn);
+        __m256 py = _mm256_blendv_ps(_mm256_loadu_ps(y + i), oy, respawn);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(vy + i), dt)));
+        _mm256_storeu_ps(life + i, _mm256_add_ps(_mm256_andnot_ps(respawn, l), dt));
+    }
+}
+
+#elif defined(__SSE__) || defined(_M_X64)
+
+void UpdateParticles(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                     float originX, float originY, float maxLifetime, float elapsed) {
+    const __m128 ox = _mm_set1_ps(originX);
+    const __m128 oy = _mm_set1_ps(originY);
+    const __m128 maxLife = _mm_set1_ps(maxLifetime);
+    const __m128 dt = _mm_set1_ps(elapsed);
+    for(unsigned int i = 0; i < size; i += 4) {
+        __m128 l = _mm_loadu_ps(life + i);
+        __m128 respawn = _mm_cmpgt_ps(l, maxLife);
+        __m128 px = _mm_or_ps(_mm_and_ps(respawn, ox), _mm_andnot_ps(respawn, _mm_loadu_ps(x + i)));
+        __m128 py = _mm_or_ps(_mm_and_ps(respawn, oy), _mm_andnot_ps(respawn, _mm_loadu_ps(y + i)));
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(vx + i), dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(vy + i), dt)));
+        _mm_storeu_ps(life + i, _mm_add_ps(_mm_andnot_ps(respawn, l), dt));
+    }
+}
+
+#else
+
+void UpdateParticles(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                     float originX, float originY, float maxLifetime, float elapsed) {
+    UpdateParticlesScalar(x, y, vx, vy, life, size, originX, originY, maxLifetime, elapsed);
+}
+
+#endif
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include "ShaderProgram.h"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+
+// Particles are kept as a structure of arrays so Update() can stream through
+// x/y/vx/vy/life four or eight lanes at a time. The arrays are padded to a
+// multiple of PARTICLE_LANES; padding particles are simulated but never drawn.
+#define PARTICLE_LANES 8
+// particles per job when one emitter's update is split across threads; a multiple of PARTICLE_LANES
+#define PARTICLE_JOB_GRAIN 2048
+// small emitters per job when a pool's emitters are updated in parallel
+#define EMITTER_JOB_GRAIN 4
+
+class JobSystem;
+
+// vertex_particle.glsl/fragment_particle.glsl plus the extra locations they need.
+// Emitters drawn with it upload their spawn data once and are animated entirely
+// by the time uniform.
+class ParticleProgram
+{
+public:
+    ParticleProgram() : linked(false) {}
+    // both return linked
+    bool Load(const char* vertexShaderFile, const char* fragmentShaderFile);
+    bool LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+
+    ShaderProgram program;
+    bool linked;
+
+    GLuint velocityAttribute;
+    GLuint ageAttribute;
+    GLint originUniform;
+    GLint timeUniform;
+    GLint maxLifetimeUniform;
+    GLint startColorUniform;
+    GLint endColorUniform;
+
+private:
+    void FindLocations();
+};
+
+class ParticleEmitter
+{
+public:
+    ParticleEmitter();
+    ParticleEmitter(glm::vec3 position, float particleLife, unsigned int particleAmount);
+    ParticleEmitter(glm::vec3 position, float emitterLife, float particleLife, unsigned int particleAmount, glm::vec4 startColor, glm::vec4 endColor);
+    // each copy streams through its own buffer, so the GL name is never shared
+    ParticleEmitter(const ParticleEmitter& other);
+    ParticleEmitter& operator=(const ParticleEmitter& other);
+    ~ParticleEmitter();
+
+    // Respawns every particle around a new position, reusing the existing storage.
+    void Restart(glm::vec3 newPosition);
+    // jobs, when given, splits large emitters across threads in lane-aligned ranges.
+    void Update(float elapsed, JobSystem* jobs = nullptr);
+    // alpha blends from the previous Update's particles (0) to the latest ones (1).
+    void Render(ShaderProgram& program, float alpha);
+    void RenderGPU(ParticleProgram& particleProgram, float alpha);
+    // For a copy of a gpuEvaluated emitter that already holds its spawn data:
+    // takes only the clock and placement, which is all that changes per step.
+    void CopyClockFrom(const ParticleEmitter& other);
+
+    // When set, Update() only advances the clock and the particles are drawn with RenderGPU().
+    bool gpuEvaluated;
+
+    bool enable;
+    glm::vec3 position;
+    glm::mat4 matrix;
+    float maxLifetime;
+    float emitterLife;
+    float timer;
+    glm::vec4 startColor;
+    glm::vec4 endColor;
+
+    unsigned int count;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> life;
+    // positions before the last Update, and that Update's elapsed time
+    std::vector<float> previousX;
+    std::vector<float> previousY;
+    float stepElapsed;
+
+private:
+    void Spawn(unsigned int particleAmount);
+    void CopyFrom(const ParticleEmitter& other);
+
+    // interleaved x, y (, r, g, b, a) written in place each frame and streamed into vbo
+    std::vector<float> vertexData;
+    GLuint vbo;
+    GLsizeiptr vboSize;
+
+    // vx, vy, starting age per particle for the GPU path, uploaded on first use
+    GLuint spawnVbo;
+    float gpuTime;
+    float previousGpuTime;
+};
+
+// Fixed set of identical one-shot emitters. Finished emitters go back on a free
+// list; when every slot is busy the oldest active emitter is restarted instead.
+class EmitterPool
+{
+public:
+    EmitterPool();
+    EmitterPool(unsigned int capacity, float emitterLife, float particleLife, unsigned int particleAmount, glm::vec4 startColor, glm::vec4 endColor);
+
+    void Emit(glm::vec3 position);
+    // jobs, when given, updates the running emitters in parallel.
+    void Update(float elapsed, JobSystem* jobs = nullptr);
+    void Render(ShaderProgram& program, float alpha);
+    void Clear();
+
+    unsigned int ActiveCount() const;
+    unsigned int Capacity() const;
+    // emitters recycled while still running because the pool was full
+    unsigned int dropped;
+
+private:
+    std::vector<ParticleEmitter> emitters;
+    std::vector<unsigned int> freeList;
+    // indices of running emitters, oldest first
+    std::vector<unsigned int> active;
+};
+
+// Advances every particle by elapsed, respawning those older than maxLifetime at
+// (originX, originY). size must be a multiple of PARTICLE_LANES.
+void UpdateParticles(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                     float originX, float originY, float maxLifetime, float elapsed);
+void UpdateParticlesScalar(float* x, float* y, const float* vx, const float* vy, float* life, unsigned int size,
+                           float originX, float originY, float maxLifetime, float elapsed);
@@ -0,0 +1,38 @@
+#include "RenderSnapshot.h"
+
+RenderSnapshot::RenderSnapshot() : valid(false), stepTime(0), timestep(0.0f), mode(0), p2Enable(false), player1Health(0), player2Health(0),
+    player1Score(-1), player2Score(-1), screenShake(false), shakeOffset(0.0f) {}
+
+static void CaptureScore(int score, int &cachedScore, std::string &text) {
+    // slots are reused, so the string only changes when the score does
+    if(score != cachedScore) {
+        cachedScore = score;
+        text = std::to_string(score);
+    }
+}
+
+void RenderSnapshot::Capture(const Simulation &sim) {
+    valid = true;
+    p2Enable = sim.p2Enable;
+    player1.Capture(sim.player1);
+    player2.Capture(sim.player2);
+    player1Health = sim.player1.health;
+    player2Health = sim.player2.health;
+    CaptureScore(sim.player1Score, player1Score, player1ScoreText);
+    CaptureScore(sim.player2Score, player2Score, player2ScoreText);
+
+    bullets.resize(sim.bullets.Size());
+    for(unsigned int i = 0; i < sim.bullets.Size(); i++) {
+        bullets[i].Capture(sim.bullets[i]);
+    }
+
+    asteroids.resize(sim.asteroids.Size());
+    outlines.clear();
+    for(unsigned int i = 0; i < sim.asteroids.Size(); i++) {
+        const Asteroid &asteroid = sim.asteroids[i];
+        asteroids[i].transform.Capture(asteroid);
+        asteroids[i].firstPoint = (int)outlines.size() / 2;
+        asteroids[i].pointCount = (int)asteroid.index.size() / 2;
+        outlines.insert(outlines.end(), asteroid.index.begin(), asteroid.index.end());
+    }
+}
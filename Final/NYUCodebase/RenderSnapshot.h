@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Simulation.h"
+#include "ParticleEmitter.h"
+
+// Both ends of one step's motion, so the renderer can blend between them.
+struct SnapshotTransform {
+    SnapshotTransform() : previousPosition(0.0f), position(0.0f), previousRotation(0.0f), rotation(0.0f) {}
+    glm::vec3 previousPosition;
+    glm::vec3 position;
+    float previousRotation;
+    float rotation;
+
+    template <typename T>
+    void Capture(const T &object) {
+        previousPosition = object.previousPosition;
+        position = object.position;
+        previousRotation = object.previousRotation;
+        rotation = object.rotation;
+    }
+    glm::mat4 Matrix(float alpha) const {
+        return interpolatedTransform(previousPosition, previousRotation, position, rotation, alpha);
+    }
+};
+
+struct AsteroidSnapshot {
+    SnapshotTransform transform;
+    // x, y pairs in RenderSnapshot::outlines
+    int firstPoint;
+    int pointCount;
+};
+
+// Everything the render thread draws for one published simulation frame. The
+// simulation thread fills a whole snapshot and never reads it back, so the
+// renderer needs no locks; vectors and strings keep their storage from one
+// capture to the next, and emitters keep their own GL buffers.
+struct RenderSnapshot {
+    RenderSnapshot();
+
+    // Copies the simulation's drawable state; the front end fills in the rest.
+    void Capture(const Simulation &sim);
+
+    bool valid;
+    // SDL_GetPerformanceCounter() when the newest step finished
+    unsigned long long stepTime;
+    float timestep;
+    // the front end's GameState
+    int mode;
+
+    bool p2Enable;
+    SnapshotTransform player1;
+    SnapshotTransform player2;
+    int player1Health;
+    int player2Health;
+    int player1Score;
+    int player2Score;
+    std::string player1ScoreText;
+    std::string player2ScoreText;
+
+    std::vector<SnapshotTransform> bullets;
+    std::vector<AsteroidSnapshot> asteroids;
+    std::vector<float> outlines;
+
+    bool screenShake;
+    glm::vec3 shakeOffset;
+    ParticleEmitter background;
+    EmitterPool collisions;
+};
@@ -0,0 +1,258 @@
+#include "Replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define REPLAY_VERSION 1
+
+enum ReplayTag { REPLAY_INPUT, REPLAY_COMMAND, REPLAY_HASH, REPLAY_END };
+
+static const char replayMagic[4] = {'A', 'R', 'P', 'L'};
+
+static void writeVarint(std::vector<unsigned char> &data, unsigned int value) {
+    while(value >= 0x80) {
+        data.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back((unsigned char)value);
+}
+
+static void writeU32(std::vector<unsigned char> &data, unsigned int value) {
+    for(int i = 0; i < 4; i++) {
+        data.push_back((unsigned char)(value >> (i * 8)));
+    }
+}
+
+static void writeFloat(std::vector<unsigned char> &data, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeU32(data, bits);
+}
+
+static bool readVarint(const std::vector<unsigned char> &data, size_t &cursor, unsigned int &value) {
+    value = 0;
+    for(int shift = 0; shift < 35; shift += 7) {
+        if(cursor >= data.size()) {
+            return false;
+        }
+        unsigned char byte = data[cursor++];
+        value |= (unsigned int)(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool readU32(const std::vector<unsigned char> &data, size_t &cursor, unsigned int &value) {
+    if(cursor + 4 > data.size()) {
+        return false;
+    }
+    value = 0;
+    for(int i = 0; i < 4; i++) {
+        value |= (unsigned int)data[cursor++] << (i * 8);
+    }
+    return true;
+}
+
+static bool readFloat(const std::vector<unsigned char> &data, size_t &cursor, float &value) {
+    unsigned int bits;
+    if(!readU32(data, cursor, bits)) {
+        return false;
+    }
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+ReplayRecorder::ReplayRecorder() : recording(false), frame(0), lastFrame(0), lastBits(0) {}
+
+void ReplayRecorder::Begin(const ReplayHeader &header) {
+    this->header = header;
+    data.clear();
+    recording = true;
+    frame = 0;
+    lastFrame = 0;
+    lastBits = 0;
+}
+
+void ReplayRecorder::Record(unsigned char tag) {
+    writeVarint(data, frame - lastFrame);
+    data.push_back(tag);
+    lastFrame = frame;
+}
+
+void ReplayRecorder::Command(SimulationCommand command) {
+    if(!recording) {
+        return;
+    }
+    Record(REPLAY_COMMAND);
+    data.push_back((unsigned char)command);
+}
+
+void ReplayRecorder::Step(unsigned int inputBits) {
+    if(!recording || inputBits == lastBits) {
+        return;
+    }
+    Record(REPLAY_INPUT);
+    writeVarint(data, inputBits);
+    lastBits = inputBits;
+}
+
+void ReplayRecorder::StepDone(const Simulation &sim) {
+    if(!recording) {
+        return;
+    }
+    if(header.hashInterval != 0 && (frame + 1) % header.hashInterval == 0) {
+        Record(REPLAY_HASH);
+        writeU32(data, sim.StateHash());
+    }
+    frame++;
+}
+
+bool ReplayRecorder::Save(const std::string fileName) const {
+    std::vector<unsigned char> file(replayMagic, replayMagic + 4);
+    file.push_back(REPLAY_VERSION);
+    writeU32(file, header.seed);
+    writeFloat(file, header.timestep);
+    writeU32(file, header.hashInterval);
+    writeFloat(file, header.player1.halfWidth);
+    writeFloat(file, header.player1.halfHeight);
+    writeFloat(file, header.player2.halfWidth);
+    writeFloat(file, header.player2.halfHeight);
+    writeFloat(file, header.bullet.halfWidth);
+    writeFloat(file, header.bullet.halfHeight);
+    file.insert(file.end(), data.begin(), data.end());
+    writeVarint(file, frame - lastFrame);
+    file.push_back(REPLAY_END);
+
+    std::ofstream outfile(fileName.c_str(), std::ios::binary);
+    if(outfile.fail()) {
+        std::cout << "Unable to write replay " << fileName << "\n";
+        return false;
+    }
+    outfile.write((const char*)file.data(), file.size());
+    return !outfile.fail();
+}
+
+bool ReplayPlayer::Load(const std::string fileName) {
+    std::ifstream infile(fileName.c_str(), std::ios::binary);
+    if(infile.fail()) {
+        std::cout << "Unable to open replay " << fileName << "\n";
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+    size_t cursor = 5;
+    if(data.size() < cursor || memcmp(data.data(), replayMagic, 4) != 0 || data[4] != REPLAY_VERSION) {
+        std::cout << "Not a replay file or wrong version: " << fileName << "\n";
+        return false;
+    }
+    bool ok = readU32(data, cursor, header.seed) &&
+              readFloat(data, cursor, header.timestep) &&
+              readU32(data, cursor, header.hashInterval) &&
+              readFloat(data, cursor, header.player1.halfWidth) &&
+              readFloat(data, cursor, header.player1.halfHeight) &&
+              readFloat(data, cursor, header.player2.halfWidth) &&
+              readFloat(data, cursor, header.player2.halfHeight) &&
+              readFloat(data, cursor, header.bullet.halfWidth) &&
+              readFloat(data, cursor, header.bullet.halfHeight);
+    if(!ok) {
+        std::cout << "Truncated replay header: " << fileName << "\n";
+        return false;
+    }
+    bodyStart = cursor;
+    return true;
+}
+
+ReplayResult ReplayPlayer::Run() {
+    ReplayResult result;
+    result.frames = 0;
+    result.hashesChecked = 0;
+    result.mismatches = 0;
+    result.firstMismatch = -1;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Simulation sim(header.player1, header.player2, header.bullet, header.seed);
+    size_t cursor = bodyStart;
+    unsigned int bits = 0;
+    unsigned int frame = 0;
+    unsigned int recordFrame = 0;
+    unsigned char tag = REPLAY_END;
+    // reads the frame delta and tag of the next record
+    auto next = [&]() -> bool {
+        unsigned int delta;
+        if(!readVarint(data, cursor, delta) || cursor >= data.size()) {
+            return false;
+        }
+        recordFrame += delta;
+        tag = data[cursor++];
+        return true;
+    };
+    bool pending = next();
+    while(pending) {
+        // input and commands for this frame come before the step, its hash after
+        while(pending && recordFrame == frame && (tag == REPLAY_INPUT || tag == REPLAY_COMMAND)) {
+            if(tag == REPLAY_INPUT) {
+                pending = readVarint(data, cursor, bits);
+            } else {
+                pending = cursor < data.size();
+                if(pending) {
+                    sim.Apply((SimulationCommand)data[cursor++]);
+                }
+            }
+            pending = pending && next();
+        }
+        if(!pending || (tag == REPLAY_END && recordFrame == frame)) {
+            break;
+        }
+        if(recordFrame < frame) {
+            std::cout << "Replay records out of order at frame " << frame << "\n";
+            break;
+        }
+        sim.Step(bits, header.timestep);
+        sim.events.clear();
+        while(pending && recordFrame == frame && tag == REPLAY_HASH) {
+            unsigned int expected;
+            pending = readU32(data, cursor, expected);
+            if(pending) {
+                result.hashesChecked++;
+                if(sim.StateHash() != expected) {
+                    if(result.mismatches == 0) {
+                        result.firstMismatch = (int)frame;
+                    }
+                    result.mismatches++;
+                }
+            }
+            pending = pending && next();
+        }
+        frame++;
+    }
+    result.frames = frame;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.narrowphase = sim.narrowphaseStats;
+    return result;
+}
+
+void PrintReplayResult(const ReplayResult &result) {
+    printf("%u frames in %.3f s (%.2f us/frame), %u/%u hashes matched", result.frames, result.seconds,
+           result.frames ? result.seconds * 1000000.0 / result.frames : 0.0, result.hashesChecked - result.mismatches, result.hashesChecked);
+    if(result.firstMismatch >= 0) {
+        printf(", first mismatch at frame %d", result.firstMismatch);
+    }
+    printf("\n");
+    PrintNarrowphaseStats(result.narrowphase);
+}
+
+void PrintNarrowphaseStats(const NarrowphaseStats &stats) {
+    if(stats.steps) {
+        printf("broadphase: %.1f proxies in %.1f cell entries per step; %llu candidate pairs of %llu brute-force pairs (%.2f%%)\n",
+               (double)stats.proxies / stats.steps, (double)stats.cellEntries / stats.steps, stats.pairs, stats.bruteForcePairs,
+               stats.bruteForcePairs ? stats.pairs * 100.0 / stats.bruteForcePairs : 0.0);
+    }
+    unsigned long long satTests = stats.pairs - stats.circleRejects - stats.boundsRejects;
+    printf("narrowphase: %llu pairs, rejected %llu by circle, %llu by box, %llu by SAT, %llu collided\n", stats.pairs, stats.circleRejects,
+           stats.boundsRejects, stats.satRejects, satTests - stats.satRejects);
+    printf("separating-axis cache: %llu pairs had an axis, %llu settled by it (%.1f%% of SAT tests)\n", stats.cachedAxes, stats.cacheHits,
+           satTests ? stats.cacheHits * 100.0 / satTests : 0.0);
+}
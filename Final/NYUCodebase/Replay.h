@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+#define REPLAY_HASH_INTERVAL 60
+
+// Everything needed to rebuild the Simulation a replay started from.
+struct ReplayHeader {
+    unsigned int seed;
+    float timestep;
+    unsigned int hashInterval;
+    SpriteExtents player1;
+    SpriteExtents player2;
+    SpriteExtents bullet;
+};
+
+// Records the input of every fixed step. Only changes are written: each record
+// is a varint frame delta, a tag and a payload (new input bits, a menu command,
+// or a state hash taken every hashInterval frames).
+class ReplayRecorder {
+    public:
+        ReplayRecorder();
+
+        void Begin(const ReplayHeader &header);
+        // before the step the command applies to
+        void Command(SimulationCommand command);
+        // before every step, with the bits the step will use
+        void Step(unsigned int inputBits);
+        // after every step
+        void StepDone(const Simulation &sim);
+        bool Save(const std::string fileName) const;
+
+        bool recording;
+        unsigned int frame;
+
+    private:
+        void Record(unsigned char tag);
+
+        ReplayHeader header;
+        std::vector<unsigned char> data;
+        unsigned int lastFrame;
+        unsigned int lastBits;
+};
+
+struct ReplayResult {
+    unsigned int frames;
+    unsigned int hashesChecked;
+    unsigned int mismatches;
+    // -1 if every hash matched
+    int firstMismatch;
+    double seconds;
+    NarrowphaseStats narrowphase;
+};
+
+// Timing, the hash check and the narrowphase counters, on stdout.
+void PrintReplayResult(const ReplayResult &result);
+// The broadphase pruning ratio, then how far candidates got through the narrowphase.
+void PrintNarrowphaseStats(const NarrowphaseStats &stats);
+
+// Re-simulates a recorded session without rendering, audio or frame pacing.
+class ReplayPlayer {
+    public:
+        bool Load(const std::string fileName);
+        ReplayResult Run();
+
+        ReplayHeader header;
+
+    private:
+        std::vector<unsigned char> data;
+        size_t bodyStart;
+};
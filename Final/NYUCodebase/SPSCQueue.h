@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// Fixed-size ring for one producer thread and one consumer thread. Neither
+// side ever blocks or retries: Write() copies what fits and Read() copies what
+// is there, each finishing in a bounded number of steps. The producer only
+// stores tail and the consumer only stores head, so the two counters never
+// contend; they sit on separate cache lines so they don't share one either.
+template <typename T>
+class SPSCQueue {
+    public:
+        // capacity is rounded up to a power of two.
+        SPSCQueue(int capacity) : head(0), tail(0) {
+            int size = 1;
+            while(size < capacity) {
+                size <<= 1;
+            }
+            items.resize(size);
+            mask = size - 1;
+        }
+
+        // Producer: copies up to count items and returns how many fit.
+        int Write(const T *data, int count) {
+            unsigned int back = tail.load(std::memory_order_relaxed);
+            unsigned int front = head.load(std::memory_order_acquire);
+            int space = (int)items.size() - (int)(back - front);
+            if(count > space) {
+                count = space;
+            }
+            for(int i = 0; i < count; i++) {
+                items[(back + i) & mask] = data[i];
+            }
+            tail.store(back + count, std::memory_order_release);
+            return count;
+        }
+        bool Push(const T &item) {
+            return Write(&item, 1) == 1;
+        }
+
+        // Consumer: copies up to count items out and returns how many there were.
+        int Read(T *out, int count) {
+            unsigned int front = head.load(std::memory_order_relaxed);
+            unsigned int back = tail.load(std::memory_order_acquire);
+            int available = (int)(back - front);
+            if(count > available) {
+                count = available;
+            }
+            for(int i = 0; i < count; i++) {
+                out[i] = items[(front + i) & mask];
+            }
+            head.store(front + count, std::memory_order_release);
+            return count;
+        }
+        bool Pop(T &item) {
+            return Read(&item, 1) == 1;
+        }
+
+        // A snapshot; either side may ask.
+        int Size() const {
+            return (int)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+        }
+        int Capacity() const {
+            return (int)items.size();
+        }
+
+    private:
+        SPSCQueue(const SPSCQueue &);
+        SPSCQueue &operator=(const SPSCQueue &);
+
+        std::vector<T> items;
+        unsigned int mask;
+        alignas(64) std::atomic<unsigned int> head;
+        alignas(64) std::atomic<unsigned int> tail;
+};
@@ -14,7 +14,10 @@
 class ShaderProgram {
     public:
 	
-		void Load(const char *vertexShaderFile, const char *fragmentShaderFile);
+		// both return whether the program linked
+		bool Load(const char *vertexShaderFile, const char *fragmentShaderFile);
+		// same as Load, for sources already read from disk
+		bool LoadFromSource(const std::string &vertexSource, const std::string &fragmentSource);
 		void Cleanup();
 
 		void SetModelMatrix(const glm::mat4 &matrix);
@@ -25,6 +28,7 @@ class ShaderProgram {
 	
         GLuint LoadShaderFromString(const std::string &shaderContents, GLenum type);
         GLuint LoadShaderFromFile(const std::string &shaderFile, GLenum type);
+        bool Link();
     
         GLuint programID;
     
@@ -35,6 +39,7 @@ class ShaderProgram {
 	
         GLuint positionAttribute;
         GLuint texCoordAttribute;
+        GLuint colorAttribute;
     
         GLuint vertexShader;
         GLuint fragmentShader;
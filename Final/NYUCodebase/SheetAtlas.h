@@ -0,0 +1,643 @@
+// Generated by tools/atlasgen.cpp from sheet.xml (1024x1024). Do not edit.
+#pragma once
+
+#include "TextureAtlas.h"
+
+namespace SheetAtlas {
+    constexpr int count = 294;
+    constexpr unsigned int bucketCount = 74;
+
+    constexpr unsigned int displacements[] = {
+        5, 10, 5, 1, 48, 568, 169, 11, 201, 15, 816, 238, 71, 2, 5, 1,
+        384, 33, 3, 29, 21, 1, 1, 457, 3, 8, 607, 697, 79, 52, 4, 33,
+        242, 87, 1366, 22, 181, 73, 2, 1, 161, 12, 1, 261, 7, 19, 810, 0,
+        421, 50, 1765, 4, 3, 363, 42, 27, 65, 36, 803, 678, 140, 83, 745, 1,
+        7, 5, 10, 2191, 479, 1837, 2, 30687, 102, 1044
+    };
+
+    constexpr int slots[] = {
+        80, 262, 10, 147, 106, 155, 139, 103, 185, 77, 284, 207, 153, 7, 224, 223,
+        52, 261, 40, 48, 92, 145, 102, 97, 200, 42, 196, 85, 282, 197, 172, 188,
+        162, 201, 242, 202, 45, 198, 163, 192, 246, 138, 90, 240, 58, 189, 215, 49,
+        251, 264, 278, 43, 252, 184, 176, 117, 280, 256, 237, 225, 71, 288, 254, 38,
+        137, 33, 270, 166, 109, 83, 250, 171, 203, 234, 178, 218, 22, 27, 101, 216,
+        60, 124, 134, 222, 244, 168, 273, 175, 257, 269, 141, 238, 277, 156, 205, 177,
+        87, 214, 65, 20, 165, 73, 41, 190, 217, 125, 70, 28, 274, 191, 127, 56,
+        161, 122, 146, 110, 32, 227, 193, 151, 142, 37, 57, 113, 235, 111, 144, 21,
+        230, 100, 158, 108, 211, 51, 84, 88, 232, 208, 180, 30, 150, 174, 69, 19,
+        94, 15, 159, 68, 226, 78, 243, 268, 17, 3, 289, 154, 266, 118, 47, 115,
+        258, 253, 66, 55, 213, 199, 233, 13, 26, 96, 179, 120, 291, 50, 245, 286,
+        6, 169, 114, 39, 35, 255, 131, 44, 210, 275, 195, 285, 0, 16, 281, 140,
+        14, 290, 126, 59, 53, 82, 170, 204, 236, 219, 104, 18, 129, 72, 24, 263,
+        76, 29, 229, 62, 143, 271, 293, 187, 54, 74, 181, 64, 1, 157, 75, 116,
+        267, 89, 8, 212, 182, 194, 95, 61, 121, 112, 173, 130, 259, 86, 287, 36,
+        132, 34, 123, 91, 283, 167, 260, 5, 209, 119, 81, 105, 149, 220, 4, 133,
+        186, 148, 248, 135, 221, 206, 183, 2, 228, 98, 23, 292, 79, 152, 272, 136,
+        9, 279, 63, 239, 249, 11, 25, 12, 99, 247, 265, 241, 67, 160, 93, 46,
+        231, 128, 164, 107, 31, 276
+    };
+
+    constexpr const char *names[] = {
+        "beam0.png",
+        "beam1.png",
+        "beam2.png",
+        "beam3.png",
+        "beam4.png",
+        "beam5.png",
+        "beam6.png",
+        "beamLong1.png",
+        "beamLong2.png",
+        "bold_silver.png",
+        "bolt_bronze.png",
+        "bolt_gold.png",
+        "buttonBlue.png",
+        "buttonGreen.png",
+        "buttonRed.png",
+        "buttonYellow.png",
+        "cockpitBlue_0.png",
+        "cockpitBlue_1.png",
+        "cockpitBlue_2.png",
+        "cockpitBlue_3.png",
+        "cockpitBlue_4.png",
+        "cockpitBlue_5.png",
+        "cockpitBlue_6.png",
+        "cockpitBlue_7.png",
+        "cockpitGreen_0.png",
+        "cockpitGreen_1.png",
+        "cockpitGreen_2.png",
+        "cockpitGreen_3.png",
+        "cockpitGreen_4.png",
+        "cockpitGreen_5.png",
+        "cockpitGreen_6.png",
+        "cockpitGreen_7.png",
+        "cockpitRed_0.png",
+        "cockpitRed_1.png",
+        "cockpitRed_2.png",
+        "cockpitRed_3.png",
+        "cockpitRed_4.png",
+        "cockpitRed_5.png",
+        "cockpitRed_6.png",
+        "cockpitRed_7.png",
+        "cockpitYellow_0.png",
+        "cockpitYellow_1.png",
+        "cockpitYellow_2.png",
+        "cockpitYellow_3.png",
+        "cockpitYellow_4.png",
+        "cockpitYellow_5.png",
+        "cockpitYellow_6.png",
+        "cockpitYellow_7.png",
+        "cursor.png",
+        "enemyBlack1.png",
+        "enemyBlack2.png",
+        "enemyBlack3.png",
+        "enemyBlack4.png",
+        "enemyBlack5.png",
+        "enemyBlue1.png",
+        "enemyBlue2.png",
+        "enemyBlue3.png",
+        "enemyBlue4.png",
+        "enemyBlue5.png",
+        "enemyGreen1.png",
+        "enemyGreen2.png",
+        "enemyGreen3.png",
+        "enemyGreen4.png",
+        "enemyGreen5.png",
+        "enemyRed1.png",
+        "enemyRed2.png",
+        "enemyRed3.png",
+        "enemyRed4.png",
+        "enemyRed5.png",
+        "engine1.png",
+        "engine2.png",
+        "engine3.png",
+        "engine4.png",
+        "engine5.png",
+        "fire00.png",
+        "fire01.png",
+        "fire02.png",
+        "fire03.png",
+        "fire04.png",
+        "fire05.png",
+        "fire06.png",
+        "fire07.png",
+        "fire08.png",
+        "fire09.png",
+        "fire10.png",
+        "fire11.png",
+        "fire12.png",
+        "fire13.png",
+        "fire14.png",
+        "fire15.png",
+        "fire16.png",
+        "fire17.png",
+        "fire18.png",
+        "fire19.png",
+        "gun00.png",
+        "gun01.png",
+        "gun02.png",
+        "gun03.png",
+        "gun04.png",
+        "gun05.png",
+        "gun06.png",
+        "gun07.png",
+        "gun08.png",
+        "gun09.png",
+        "gun10.png",
+        "laserBlue01.png",
+        "laserBlue02.png",
+        "laserBlue03.png",
+        "laserBlue04.png",
+        "laserBlue05.png",
+        "laserBlue06.png",
+        "laserBlue07.png",
+        "laserBlue08.png",
+        "laserBlue09.png",
+        "laserBlue10.png",
+        "laserBlue11.png",
+        "laserBlue12.png",
+        "laserBlue13.png",
+        "laserBlue14.png",
+        "laserBlue15.png",
+        "laserBlue16.png",
+        "laserGreen01.png",
+        "laserGreen02.png",
+        "laserGreen03.png",
+        "laserGreen04.png",
+        "laserGreen05.png",
+        "laserGreen06.png",
+        "laserGreen07.png",
+        "laserGreen08.png",
+        "laserGreen09.png",
+        "laserGreen10.png",
+        "laserGreen11.png",
+        "laserGreen12.png",
+        "laserGreen13.png",
+        "laserGreen14.png",
+        "laserGreen15.png",
+        "laserGreen16.png",
+        "laserRed01.png",
+        "laserRed02.png",
+        "laserRed03.png",
+        "laserRed04.png",
+        "laserRed05.png",
+        "laserRed06.png",
+        "laserRed07.png",
+        "laserRed08.png",
+        "laserRed09.png",
+        "laserRed10.png",
+        "laserRed11.png",
+        "laserRed12.png",
+        "laserRed13.png",
+        "laserRed14.png",
+        "laserRed15.png",
+        "laserRed16.png",
+        "meteorBrown_big1.png",
+        "meteorBrown_big2.png",
+        "meteorBrown_big3.png",
+        "meteorBrown_big4.png",
+        "meteorBrown_med1.png",
+        "meteorBrown_med3.png",
+        "meteorBrown_small1.png",
+        "meteorBrown_small2.png",
+        "meteorBrown_tiny1.png",
+        "meteorBrown_tiny2.png",
+        "meteorGrey_big1.png",
+        "meteorGrey_big2.png",
+        "meteorGrey_big3.png",
+        "meteorGrey_big4.png",
+        "meteorGrey_med1.png",
+        "meteorGrey_med2.png",
+        "meteorGrey_small1.png",
+        "meteorGrey_small2.png",
+        "meteorGrey_tiny1.png",
+        "meteorGrey_tiny2.png",
+        "numeral0.png",
+        "numeral1.png",
+        "numeral2.png",
+        "numeral3.png",
+        "numeral4.png",
+        "numeral5.png",
+        "numeral6.png",
+        "numeral7.png",
+        "numeral8.png",
+        "numeral9.png",
+        "numeralX.png",
+        "pill_blue.png",
+        "pill_green.png",
+        "pill_red.png",
+        "pill_yellow.png",
+        "playerLife1_blue.png",
+        "playerLife1_green.png",
+        "playerLife1_orange.png",
+        "playerLife1_red.png",
+        "playerLife2_blue.png",
+        "playerLife2_green.png",
+        "playerLife2_orange.png",
+        "playerLife2_red.png",
+        "playerLife3_blue.png",
+        "playerLife3_green.png",
+        "playerLife3_orange.png",
+        "playerLife3_red.png",
+        "playerShip1_blue.png",
+        "playerShip1_damage1.png",
+        "playerShip1_damage2.png",
+        "playerShip1_damage3.png",
+        "playerShip1_green.png",
+        "playerShip1_orange.png",
+        "playerShip1_red.png",
+        "playerShip2_blue.png",
+        "playerShip2_damage1.png",
+        "playerShip2_damage2.png",
+        "playerShip2_damage3.png",
+        "playerShip2_green.png",
+        "playerShip2_orange.png",
+        "playerShip2_red.png",
+        "playerShip3_blue.png",
+        "playerShip3_damage1.png",
+        "playerShip3_damage2.png",
+        "playerShip3_damage3.png",
+        "playerShip3_green.png",
+        "playerShip3_orange.png",
+        "playerShip3_red.png",
+        "powerupBlue.png",
+        "powerupBlue_bolt.png",
+        "powerupBlue_shield.png",
+        "powerupBlue_star.png",
+        "powerupGreen.png",
+        "powerupGreen_bolt.png",
+        "powerupGreen_shield.png",
+        "powerupGreen_star.png",
+        "powerupRed.png",
+        "powerupRed_bolt.png",
+        "powerupRed_shield.png",
+        "powerupRed_star.png",
+        "powerupYellow.png",
+        "powerupYellow_bolt.png",
+        "powerupYellow_shield.png",
+        "powerupYellow_star.png",
+        "scratch1.png",
+        "scratch2.png",
+        "scratch3.png",
+        "shield1.png",
+        "shield2.png",
+        "shield3.png",
+        "shield_bronze.png",
+        "shield_gold.png",
+        "shield_silver.png",
+        "speed.png",
+        "star1.png",
+        "star2.png",
+        "star3.png",
+        "star_bronze.png",
+        "star_gold.png",
+        "star_silver.png",
+        "things_bronze.png",
+        "things_gold.png",
+        "things_silver.png",
+        "turretBase_big.png",
+        "turretBase_small.png",
+        "ufoBlue.png",
+        "ufoGreen.png",
+        "ufoRed.png",
+        "ufoYellow.png",
+        "wingBlue_0.png",
+        "wingBlue_1.png",
+        "wingBlue_2.png",
+        "wingBlue_3.png",
+        "wingBlue_4.png",
+        "wingBlue_5.png",
+        "wingBlue_6.png",
+        "wingBlue_7.png",
+        "wingGreen_0.png",
+        "wingGreen_1.png",
+        "wingGreen_2.png",
+        "wingGreen_3.png",
+        "wingGreen_4.png",
+        "wingGreen_5.png",
+        "wingGreen_6.png",
+        "wingGreen_7.png",
+        "wingRed_0.png",
+        "wingRed_1.png",
+        "wingRed_2.png",
+        "wingRed_3.png",
+        "wingRed_4.png",
+        "wingRed_5.png",
+        "wingRed_6.png",
+        "wingRed_7.png",
+        "wingYellow_0.png",
+        "wingYellow_1.png",
+        "wingYellow_2.png",
+        "wingYellow_3.png",
+        "wingYellow_4.png",
+        "wingYellow_5.png",
+        "wingYellow_6.png",
+        "wingYellow_7.png"
+    };
+
+    constexpr AtlasRegion regions[] = {
+        {0.139648438f, 0.368164062f, 0.0419921875f, 0.0302734375f},
+        {0.319335938f, 0.62890625f, 0.0390625f, 0.01953125f},
+        {0.255859375f, 0.885742188f, 0.037109375f, 0.0302734375f},
+        {0.38671875f, 0.375f, 0.0283203125f, 0.0283203125f},
+        {0.172851562f, 0.484375f, 0.0400390625f, 0.0166015625f},
+        {0.181640625f, 0.368164062f, 0.0390625f, 0.0244140625f},
+        {0.1171875f, 0.671875f, 0.0419921875f, 0.0224609375f},
+        {0.80859375f, 0.920898438f, 0.0146484375f, 0.0654296875f},
+        {0.299804688f, 0.301757812f, 0.0244140625f, 0.0625f},
+        {0.791015625f, 0.817382812f, 0.0185546875f, 0.029296875f},
+        {0.791015625f, 0.456054688f, 0.0185546875f, 0.029296875f},
+        {0.790039062f, 0.426757812f, 0.0185546875f, 0.029296875f},
+        {0.0f, 0.076171875f, 0.216796875f, 0.0380859375f},
+        {0.0f, 0.114257812f, 0.216796875f, 0.0380859375f},
+        {0.0f, 0.0f, 0.216796875f, 0.0380859375f},
+        {0.0f, 0.0380859375f, 0.216796875f, 0.0380859375f},
+        {0.572265625f, 0.0f, 0.0498046875f, 0.0732421875f},
+        {0.71875f, 0.841796875f, 0.0390625f, 0.0390625f},
+        {0.66796875f, 0.0654296875f, 0.041015625f, 0.0546875f},
+        {0.328125f, 0.375f, 0.05859375f, 0.0595703125f},
+        {0.622070312f, 0.0f, 0.0458984375f, 0.0654296875f},
+        {0.612304688f, 0.140625f, 0.046875f, 0.0732421875f},
+        {0.66796875f, 0.0f, 0.041015625f, 0.0654296875f},
+        {0.719726562f, 0.529296875f, 0.0400390625f, 0.0693359375f},
+        {0.5625f, 0.219726562f, 0.0498046875f, 0.0732421875f},
+        {0.716796875f, 0.954101562f, 0.0390625f, 0.0390625f},
+        {0.6796875f, 0.643554688f, 0.041015625f, 0.0546875f},
+        {0.337890625f, 0.228515625f, 0.05859375f, 0.0595703125f},
+        {0.612304688f, 0.213867188f, 0.0458984375f, 0.0654296875f},
+        {0.677734375f, 0.35546875f, 0.041015625f, 0.0654296875f},
+        {0.719726562f, 0.459960938f, 0.0400390625f, 0.0693359375f},
+        {0.587890625f, 0.512695312f, 0.046875f, 0.0732421875f},
+        {0.522460938f, 0.0732421875f, 0.0498046875f, 0.0732421875f},
+        {0.342773438f, 0.958984375f, 0.0390625f, 0.0390625f},
+        {0.701171875f, 0.192382812f, 0.041015625f, 0.0546875f},
+        {0.5078125f, 0.645507812f, 0.05859375f, 0.0595703125f},
+        {0.631835938f, 0.836914062f, 0.0458984375f, 0.0654296875f},
+        {0.590820312f, 0.690429688f, 0.046875f, 0.0732421875f},
+        {0.71875f, 0.776367188f, 0.041015625f, 0.0654296875f},
+        {0.71875f, 0.321289062f, 0.0400390625f, 0.0693359375f},
+        {0.708984375f, 0.078125f, 0.0390625f, 0.0390625f},
+        {0.241210938f, 0.301757812f, 0.05859375f, 0.0595703125f},
+        {0.622070312f, 0.0654296875f, 0.0458984375f, 0.0654296875f},
+        {0.592773438f, 0.763671875f, 0.046875f, 0.0732421875f},
+        {0.6796875f, 0.255859375f, 0.041015625f, 0.0654296875f},
+        {0.71875f, 0.390625f, 0.0400390625f, 0.0693359375f},
+        {0.716796875f, 0.899414062f, 0.041015625f, 0.0546875f},
+        {0.5859375f, 0.366210938f, 0.0498046875f, 0.0732421875f},
+        {0.778320312f, 0.168945312f, 0.029296875f, 0.0322265625f},
+        {0.413085938f, 0.7109375f, 0.0908203125f, 0.08203125f},
+        {0.1171875f, 0.58984375f, 0.1015625f, 0.08203125f},
+        {0.140625f, 0.15234375f, 0.100585938f, 0.08203125f},
+        {0.505859375f, 0.317382812f, 0.080078125f, 0.08203125f},
+        {0.337890625f, 0.146484375f, 0.0947265625f, 0.08203125f},
+        {0.415039062f, 0.45703125f, 0.0908203125f, 0.08203125f},
+        {0.139648438f, 0.286132812f, 0.1015625f, 0.08203125f},
+        {0.216796875f, 0.0f, 0.100585938f, 0.08203125f},
+        {0.505859375f, 0.399414062f, 0.080078125f, 0.08203125f},
+        {0.411132812f, 0.794921875f, 0.0947265625f, 0.08203125f},
+        {0.415039062f, 0.5390625f, 0.0908203125f, 0.08203125f},
+        {0.129882812f, 0.40234375f, 0.1015625f, 0.08203125f},
+        {0.21875f, 0.484375f, 0.100585938f, 0.08203125f},
+        {0.505859375f, 0.481445312f, 0.080078125f, 0.08203125f},
+        {0.3984375f, 0.885742188f, 0.0947265625f, 0.08203125f},
+        {0.415039062f, 0.375f, 0.0908203125f, 0.08203125f},
+        {0.1171875f, 0.5078125f, 0.1015625f, 0.08203125f},
+        {0.21875f, 0.56640625f, 0.100585938f, 0.08203125f},
+        {0.5078125f, 0.563476562f, 0.080078125f, 0.08203125f},
+        {0.413085938f, 0.62890625f, 0.0947265625f, 0.08203125f},
+        {0.21875f, 0.885742188f, 0.037109375f, 0.0224609375f},
+        {0.159179688f, 0.671875f, 0.041015625f, 0.02734375f},
+        {0.62890625f, 0.978515625f, 0.0263671875f, 0.021484375f},
+        {0.140625f, 0.234375f, 0.0478515625f, 0.0439453125f},
+        {0.129882812f, 0.484375f, 0.04296875f, 0.0234375f},
+        {0.807617188f, 0.122070312f, 0.015625f, 0.0390625f},
+        {0.80859375f, 0.201171875f, 0.013671875f, 0.0302734375f},
+        {0.807617188f, 0.647460938f, 0.013671875f, 0.03125f},
+        {0.809570312f, 0.426757812f, 0.013671875f, 0.033203125f},
+        {0.811523438f, 0.0f, 0.013671875f, 0.0302734375f},
+        {0.814453125f, 0.291992188f, 0.013671875f, 0.0302734375f},
+        {0.815429688f, 0.490234375f, 0.013671875f, 0.0302734375f},
+        {0.815429688f, 0.322265625f, 0.013671875f, 0.0302734375f},
+        {0.807617188f, 0.846679688f, 0.015625f, 0.0390625f},
+        {0.791992188f, 0.647460938f, 0.015625f, 0.0390625f},
+        {0.79296875f, 0.201171875f, 0.015625f, 0.0390625f},
+        {0.815429688f, 0.385742188f, 0.013671875f, 0.0302734375f},
+        {0.815429688f, 0.520507812f, 0.013671875f, 0.03125f},
+        {0.815429688f, 0.352539062f, 0.013671875f, 0.033203125f},
+        {0.811523438f, 0.0302734375f, 0.013671875f, 0.0302734375f},
+        {0.809570312f, 0.459960938f, 0.013671875f, 0.0302734375f},
+        {0.80859375f, 0.26171875f, 0.013671875f, 0.0302734375f},
+        {0.80859375f, 0.231445312f, 0.013671875f, 0.0302734375f},
+        {0.807617188f, 0.161132812f, 0.015625f, 0.0400390625f},
+        {0.79296875f, 0.240234375f, 0.015625f, 0.0400390625f},
+        {0.807617188f, 0.885742188f, 0.015625f, 0.03515625f},
+        {0.791015625f, 0.846679688f, 0.0166015625f, 0.0322265625f},
+        {0.809570312f, 0.596679688f, 0.013671875f, 0.03515625f},
+        {0.790039062f, 0.77734375f, 0.01953125f, 0.0400390625f},
+        {0.807617188f, 0.08203125f, 0.015625f, 0.0400390625f},
+        {0.413085938f, 0.0f, 0.0205078125f, 0.0400390625f},
+        {0.791015625f, 0.87890625f, 0.0166015625f, 0.037109375f},
+        {0.809570312f, 0.77734375f, 0.013671875f, 0.0400390625f},
+        {0.828125f, 0.256835938f, 0.009765625f, 0.0458984375f},
+        {0.790039062f, 0.596679688f, 0.01953125f, 0.05078125f},
+        {0.7890625f, 0.938476562f, 0.01953125f, 0.05078125f},
+        {0.8359375f, 0.411132812f, 0.0087890625f, 0.052734375f},
+        {0.821289062f, 0.631835938f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.0556640625f, 0.0087890625f, 0.0361328125f},
+        {0.815429688f, 0.551757812f, 0.0126953125f, 0.0361328125f},
+        {0.837890625f, 0.463867188f, 0.0087890625f, 0.0361328125f},
+        {0.815429688f, 0.734375f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.756835938f, 0.0087890625f, 0.0361328125f},
+        {0.58203125f, 0.938476562f, 0.046875f, 0.044921875f},
+        {0.423828125f, 0.317382812f, 0.046875f, 0.044921875f},
+        {0.72265625f, 0.70703125f, 0.0361328125f, 0.0361328125f},
+        {0.681640625f, 0.776367188f, 0.037109375f, 0.0361328125f},
+        {0.815429688f, 0.678710938f, 0.0126953125f, 0.0556640625f},
+        {0.8359375f, 0.848632812f, 0.0087890625f, 0.0556640625f},
+        {0.822265625f, 0.201171875f, 0.0126953125f, 0.0556640625f},
+        {0.829101562f, 0.46875f, 0.0087890625f, 0.0556640625f},
+        {0.823242188f, 0.060546875f, 0.0126953125f, 0.052734375f},
+        {0.72265625f, 0.669921875f, 0.0361328125f, 0.037109375f},
+        {0.823242188f, 0.11328125f, 0.0126953125f, 0.0556640625f},
+        {0.834960938f, 0.168945312f, 0.0087890625f, 0.0556640625f},
+        {0.828125f, 0.551757812f, 0.0126953125f, 0.0361328125f},
+        {0.833984375f, 0.624023438f, 0.0087890625f, 0.0361328125f},
+        {0.825195312f, 0.0f, 0.0126953125f, 0.0556640625f},
+        {0.829101562f, 0.35546875f, 0.0087890625f, 0.0556640625f},
+        {0.828125f, 0.720703125f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.091796875f, 0.0087890625f, 0.0361328125f},
+        {0.823242188f, 0.416015625f, 0.0126953125f, 0.052734375f},
+        {0.829101562f, 0.302734375f, 0.0087890625f, 0.052734375f},
+        {0.823242188f, 0.587890625f, 0.0126953125f, 0.0361328125f},
+        {0.837890625f, 0.0f, 0.0087890625f, 0.0361328125f},
+        {0.188476562f, 0.234375f, 0.046875f, 0.044921875f},
+        {0.432617188f, 0.177734375f, 0.046875f, 0.044921875f},
+        {0.7421875f, 0.1875f, 0.0361328125f, 0.0361328125f},
+        {0.837890625f, 0.224609375f, 0.0087890625f, 0.052734375f},
+        {0.823242188f, 0.954101562f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.587890625f, 0.0087890625f, 0.0361328125f},
+        {0.823242188f, 0.91796875f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.959960938f, 0.0087890625f, 0.0361328125f},
+        {0.823242188f, 0.881835938f, 0.0126953125f, 0.0361328125f},
+        {0.8359375f, 0.127929688f, 0.0087890625f, 0.0361328125f},
+        {0.56640625f, 0.645507812f, 0.046875f, 0.044921875f},
+        {0.587890625f, 0.5859375f, 0.046875f, 0.044921875f},
+        {0.720703125f, 0.634765625f, 0.0361328125f, 0.03515625f},
+        {0.719726562f, 0.598632812f, 0.0361328125f, 0.0361328125f},
+        {0.823242188f, 0.826171875f, 0.0126953125f, 0.0556640625f},
+        {0.8359375f, 0.79296875f, 0.0087890625f, 0.0556640625f},
+        {0.823242188f, 0.770507812f, 0.0126953125f, 0.0556640625f},
+        {0.8359375f, 0.904296875f, 0.0087890625f, 0.0556640625f},
+        {0.828125f, 0.66796875f, 0.0126953125f, 0.052734375f},
+        {0.21875f, 0.6484375f, 0.0986328125f, 0.08203125f},
+        {0.0f, 0.5078125f, 0.1171875f, 0.095703125f},
+        {0.505859375f, 0.791015625f, 0.0869140625f, 0.080078125f},
+        {0.319335938f, 0.44140625f, 0.095703125f, 0.09375f},
+        {0.635742188f, 0.436523438f, 0.0419921875f, 0.0419921875f},
+        {0.231445312f, 0.44140625f, 0.0439453125f, 0.0390625f},
+        {0.396484375f, 0.228515625f, 0.02734375f, 0.02734375f},
+        {0.759765625f, 0.573242188f, 0.0283203125f, 0.025390625f},
+        {0.337890625f, 0.794921875f, 0.017578125f, 0.017578125f},
+        {0.389648438f, 0.794921875f, 0.015625f, 0.0146484375f},
+        {0.21875f, 0.73046875f, 0.0986328125f, 0.08203125f},
+        {0.0f, 0.603515625f, 0.1171875f, 0.095703125f},
+        {0.50390625f, 0.7109375f, 0.0869140625f, 0.080078125f},
+        {0.319335938f, 0.53515625f, 0.095703125f, 0.09375f},
+        {0.658203125f, 0.213867188f, 0.0419921875f, 0.0419921875f},
+        {0.275390625f, 0.44140625f, 0.0439453125f, 0.0390625f},
+        {0.396484375f, 0.255859375f, 0.02734375f, 0.02734375f},
+        {0.38671875f, 0.403320312f, 0.0283203125f, 0.025390625f},
+        {0.35546875f, 0.794921875f, 0.017578125f, 0.017578125f},
+        {0.587890625f, 0.630859375f, 0.015625f, 0.0146484375f},
+        {0.358398438f, 0.62890625f, 0.0185546875f, 0.0185546875f},
+        {0.200195312f, 0.671875f, 0.0185546875f, 0.0185546875f},
+        {0.396484375f, 0.283203125f, 0.0185546875f, 0.0185546875f},
+        {0.56640625f, 0.690429688f, 0.0185546875f, 0.0185546875f},
+        {0.376953125f, 0.62890625f, 0.0185546875f, 0.0185546875f},
+        {0.61328125f, 0.630859375f, 0.0185546875f, 0.0185546875f},
+        {0.655273438f, 0.978515625f, 0.0185546875f, 0.0185546875f},
+        {0.673828125f, 0.98046875f, 0.0185546875f, 0.0185546875f},
+        {0.692382812f, 0.98046875f, 0.0185546875f, 0.0185546875f},
+        {0.479492188f, 0.209960938f, 0.0185546875f, 0.0185546875f},
+        {0.373046875f, 0.794921875f, 0.0166015625f, 0.0166015625f},
+        {0.658203125f, 0.255859375f, 0.021484375f, 0.0205078125f},
+        {0.559570312f, 0.965820312f, 0.021484375f, 0.0205078125f},
+        {0.216796875f, 0.10546875f, 0.021484375f, 0.0205078125f},
+        {0.216796875f, 0.125976562f, 0.021484375f, 0.0205078125f},
+        {0.470703125f, 0.349609375f, 0.0322265625f, 0.025390625f},
+        {0.522460938f, 0.146484375f, 0.0322265625f, 0.025390625f},
+        {0.758789062f, 0.319335938f, 0.0322265625f, 0.025390625f},
+        {0.756835938f, 0.293945312f, 0.0322265625f, 0.025390625f},
+        {0.454101562f, 0.967773438f, 0.0361328125f, 0.025390625f},
+        {0.381835938f, 0.967773438f, 0.0361328125f, 0.025390625f},
+        {0.41796875f, 0.967773438f, 0.0361328125f, 0.025390625f},
+        {0.490234375f, 0.967773438f, 0.0361328125f, 0.025390625f},
+        {0.758789062f, 0.375976562f, 0.03125f, 0.025390625f},
+        {0.759765625f, 0.458007812f, 0.03125f, 0.025390625f},
+        {0.758789062f, 0.6953125f, 0.03125f, 0.025390625f},
+        {0.758789062f, 0.432617188f, 0.03125f, 0.025390625f},
+        {0.206054688f, 0.918945312f, 0.0966796875f, 0.0732421875f},
+        {0.109375f, 0.918945312f, 0.0966796875f, 0.0732421875f},
+        {0.241210938f, 0.228515625f, 0.0966796875f, 0.0732421875f},
+        {0.241210938f, 0.155273438f, 0.0966796875f, 0.0732421875f},
+        {0.231445312f, 0.368164062f, 0.0966796875f, 0.0732421875f},
+        {0.241210938f, 0.08203125f, 0.0966796875f, 0.0732421875f},
+        {0.21875f, 0.8125f, 0.0966796875f, 0.0732421875f},
+        {0.109375f, 0.772460938f, 0.109375f, 0.0732421875f},
+        {0.0f, 0.845703125f, 0.109375f, 0.0732421875f},
+        {0.0f, 0.772460938f, 0.109375f, 0.0732421875f},
+        {0.0f, 0.69921875f, 0.109375f, 0.0732421875f},
+        {0.109375f, 0.845703125f, 0.109375f, 0.0732421875f},
+        {0.109375f, 0.69921875f, 0.109375f, 0.0732421875f},
+        {0.0f, 0.918945312f, 0.109375f, 0.0732421875f},
+        {0.317382812f, 0.721679688f, 0.095703125f, 0.0732421875f},
+        {0.315429688f, 0.8125f, 0.095703125f, 0.0732421875f},
+        {0.302734375f, 0.885742188f, 0.095703125f, 0.0732421875f},
+        {0.317382812f, 0.6484375f, 0.095703125f, 0.0732421875f},
+        {0.337890625f, 0.0732421875f, 0.095703125f, 0.0732421875f},
+        {0.328125f, 0.301757812f, 0.095703125f, 0.0732421875f},
+        {0.317382812f, 0.0f, 0.095703125f, 0.0732421875f},
+        {0.6796875f, 0.321289062f, 0.033203125f, 0.0322265625f},
+        {0.526367188f, 0.965820312f, 0.033203125f, 0.0322265625f},
+        {0.758789062f, 0.663085938f, 0.033203125f, 0.0322265625f},
+        {0.7578125f, 0.874023438f, 0.033203125f, 0.0322265625f},
+        {0.755859375f, 0.598632812f, 0.033203125f, 0.0322265625f},
+        {0.748046875f, 0.078125f, 0.033203125f, 0.0322265625f},
+        {0.7578125f, 0.841796875f, 0.033203125f, 0.0322265625f},
+        {0.635742188f, 0.478515625f, 0.033203125f, 0.0322265625f},
+        {0.479492188f, 0.177734375f, 0.033203125f, 0.0322265625f},
+        {0.756835938f, 0.630859375f, 0.033203125f, 0.0322265625f},
+        {0.7578125f, 0.90625f, 0.033203125f, 0.0322265625f},
+        {0.755859375f, 0.954101562f, 0.033203125f, 0.0322265625f},
+        {0.755859375f, 0.743164062f, 0.033203125f, 0.0322265625f},
+        {0.72265625f, 0.743164062f, 0.033203125f, 0.0322265625f},
+        {0.470703125f, 0.317382812f, 0.033203125f, 0.0322265625f},
+        {0.592773438f, 0.836914062f, 0.033203125f, 0.0322265625f},
+        {0.317382812f, 0.794921875f, 0.0205078125f, 0.015625f},
+        {0.413085938f, 0.0400390625f, 0.0205078125f, 0.015625f},
+        {0.337890625f, 0.288085938f, 0.015625f, 0.01171875f},
+        {0.0f, 0.40234375f, 0.129882812f, 0.10546875f},
+        {0.0f, 0.286132812f, 0.139648438f, 0.116210938f},
+        {0.0f, 0.15234375f, 0.140625f, 0.133789062f},
+        {0.778320312f, 0.139648438f, 0.029296875f, 0.029296875f},
+        {0.778320312f, 0.110351562f, 0.029296875f, 0.029296875f},
+        {0.759765625f, 0.8046875f, 0.029296875f, 0.029296875f},
+        {0.837890625f, 0.27734375f, 0.0068359375f, 0.10546875f},
+        {0.61328125f, 0.665039062f, 0.0244140625f, 0.0234375f},
+        {0.216796875f, 0.08203125f, 0.0244140625f, 0.0234375f},
+        {0.5625f, 0.29296875f, 0.0234375f, 0.0234375f},
+        {0.759765625f, 0.775390625f, 0.0302734375f, 0.029296875f},
+        {0.759765625f, 0.543945312f, 0.0302734375f, 0.029296875f},
+        {0.759765625f, 0.514648438f, 0.0302734375f, 0.029296875f},
+        {0.759765625f, 0.483398438f, 0.03125f, 0.03125f},
+        {0.758789062f, 0.401367188f, 0.03125f, 0.03125f},
+        {0.758789062f, 0.344726562f, 0.03125f, 0.03125f},
+        {0.302734375f, 0.958984375f, 0.0400390625f, 0.0400390625f},
+        {0.7890625f, 0.293945312f, 0.025390625f, 0.025390625f},
+        {0.43359375f, 0.0888671875f, 0.0888671875f, 0.0888671875f},
+        {0.423828125f, 0.228515625f, 0.0888671875f, 0.0888671875f},
+        {0.43359375f, 0.0f, 0.0888671875f, 0.0888671875f},
+        {0.493164062f, 0.876953125f, 0.0888671875f, 0.0888671875f},
+        {0.631835938f, 0.90234375f, 0.0439453125f, 0.076171875f},
+        {0.720703125f, 0.247070312f, 0.0361328125f, 0.0703125f},
+        {0.786132812f, 0.0f, 0.025390625f, 0.08203125f},
+        {0.5859375f, 0.439453125f, 0.0498046875f, 0.0732421875f},
+        {0.67578125f, 0.90234375f, 0.041015625f, 0.078125f},
+        {0.58203125f, 0.87109375f, 0.0498046875f, 0.0673828125f},
+        {0.677734375f, 0.827148438f, 0.041015625f, 0.072265625f},
+        {0.659179688f, 0.130859375f, 0.0419921875f, 0.0810546875f},
+        {0.634765625f, 0.512695312f, 0.0439453125f, 0.076171875f},
+        {0.756835938f, 0.223632812f, 0.0361328125f, 0.0703125f},
+        {0.790039062f, 0.514648438f, 0.025390625f, 0.08203125f},
+        {0.522460938f, 0.0f, 0.0498046875f, 0.0732421875f},
+        {0.677734375f, 0.420898438f, 0.041015625f, 0.078125f},
+        {0.512695312f, 0.245117188f, 0.0498046875f, 0.0673828125f},
+        {0.678710938f, 0.499023438f, 0.041015625f, 0.072265625f},
+        {0.639648438f, 0.74609375f, 0.0419921875f, 0.0810546875f},
+        {0.790039062f, 0.6953125f, 0.025390625f, 0.08203125f},
+        {0.75f, 0.0f, 0.0361328125f, 0.0703125f},
+        {0.5859375f, 0.29296875f, 0.0498046875f, 0.0732421875f},
+        {0.681640625f, 0.698242188f, 0.041015625f, 0.078125f},
+        {0.572265625f, 0.0732421875f, 0.0498046875f, 0.0673828125f},
+        {0.701171875f, 0.120117188f, 0.041015625f, 0.072265625f},
+        {0.637695312f, 0.665039062f, 0.0419921875f, 0.0810546875f},
+        {0.635742188f, 0.279296875f, 0.0439453125f, 0.076171875f},
+        {0.634765625f, 0.588867188f, 0.0439453125f, 0.076171875f},
+        {0.7421875f, 0.1171875f, 0.0361328125f, 0.0703125f},
+        {0.790039062f, 0.344726562f, 0.025390625f, 0.08203125f},
+        {0.5625f, 0.146484375f, 0.0498046875f, 0.0732421875f},
+        {0.708984375f, 0.0f, 0.041015625f, 0.078125f},
+        {0.512695312f, 0.177734375f, 0.0498046875f, 0.0673828125f},
+        {0.678710938f, 0.571289062f, 0.041015625f, 0.072265625f},
+        {0.635742188f, 0.35546875f, 0.0419921875f, 0.0810546875f}
+    };
+
+    // Unknown names reach the throw, which is not a constant expression, so
+    // a misspelt sprite fails to compile when used in a constant context.
+    constexpr int checked(const char *name, int index) {
+        return (index >= 0 && AtlasNameEquals(names[index], name)) ? index : throw "unknown atlas region";
+    }
+
+    constexpr int find(const char *name) {
+        return checked(name, slots[AtlasHash(name, displacements[AtlasHash(name, 0u) % bucketCount]) % count]);
+    }
+}
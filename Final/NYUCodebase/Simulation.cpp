@@ -0,0 +1,617 @@
+#include "Simulation.h"
+#include "JobSystem.h"
+#include <math.h>
+#include <assert.h>
+#include <algorithm>
+
+bool operator==(Asteroid& left, Asteroid& right)
+{
+    if(left.index.size() == right.index.size())
+    {
+        for(int check = 0; check < left.index.size(); check++)
+        {
+            if(left.index[check] != right.index[check])
+            {
+                return false;
+            }
+        }
+        if(left.matrix == right.matrix)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+bool operator!=(Asteroid& left, Asteroid& right)
+{
+    return !(left == right);
+}
+
+Simulation::Simulation(SpriteExtents player1Extents, SpriteExtents player2Extents, SpriteExtents bulletExtents, unsigned int seed) : jobs(nullptr)
+{
+    random.Seed(seed);
+    p2Enable = false;
+    player1 = Entity(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.132f, 0.1f, 0.0f), 0.0f, glm::vec3(1.0f, 1.0f, 1.0f), PLAYER);
+    player2 = Entity(glm::vec3(0.25f, 0.0f, 0.0f), glm::vec3(0.132f, 0.1f, 0.0f), 0.0f, glm::vec3(1.0f, 1.0f, 1.0f), PLAYER);
+    player1.setEdgeSet(player1Extents);
+    player2.setEdgeSet(player2Extents);
+    player2.playerTag = 2;
+    max_bullets = 20;
+    bulletIndex = 0;
+    bullets = ObjectPool<Entity>(max_bullets);
+    bulletHandles = std::vector<PoolHandle>(max_bullets);
+    bulletTemplate = Entity(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.1f, 0.1f, 0.0f), 0.0f, glm::vec3(0.5f, 0.5f, 0.0f), BULLET);
+    bulletTemplate.setEdgeSet(bulletExtents);
+    asteroids = ObjectPool<Asteroid>(MAX_ASTEROIDS);
+    possibleIndices.push_back({ -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f});
+    possibleIndices.push_back({ -0.4, -0.4f, 0.4f, -0.4f, 0.6f, 0.0f, 0.5f, 0.5f, -0.6f, 0.0f});
+    possibleIndices.push_back({ -0.5, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f});
+    possibleIndices.push_back({ -0.4f, -0.4f, 0.4f, -0.4f, 0.8f, 0.0f, 0.4f, 0.4f, -0.4f, 0.4f, -0.8f, 0.0f });
+    possibleAxes.resize(possibleIndices.size());
+    for(int i = 0; i < possibleIndices.size(); i++)
+    {
+        BuildHullAxes(possibleIndices[i].data(), (int)possibleIndices[i].size()/2, possibleAxes[i]);
+    }
+    asteroidInitialization();
+    player1Score = 0;
+    player2Score = 0;
+    timer = 0.0f;
+}
+
+void Simulation::insertProxy(const CollisionBounds& bounds, int index, unsigned int layer, unsigned int mask)
+{
+    broadphase.Insert(index, layer, mask, bounds.minimum.x, bounds.minimum.y, bounds.maximum.x, bounds.maximum.y);
+}
+
+const CollisionBounds& Simulation::proxyShape(const BroadphaseProxy& proxy, HullSpan& hull, AxisSpan& axes) const
+{
+    if(proxy.layer == LAYER_PLAYER)
+    {
+        const Entity& player = (proxy.index == 1) ? player1 : player2;
+        hull = player.hullSpan();
+        axes = player.axisSpan();
+        return player.bounds;
+    }
+    else if(proxy.layer == LAYER_BULLET)
+    {
+        hull = bullets[proxy.index].hullSpan();
+        axes = bullets[proxy.index].axisSpan();
+        return bullets[proxy.index].bounds;
+    }
+    hull = asteroids[proxy.index].hullSpan();
+    axes = asteroids[proxy.index].axisSpan();
+    return asteroids[proxy.index].bounds;
+}
+
+static_assert(MAX_ASTEROIDS < (1 << 30), "asteroid slots must fit in proxyIdentity's 30 bits");
+
+unsigned long long Simulation::proxyIdentity(const BroadphaseProxy& proxy) const
+{
+    // two bits of kind and a 30 bit slot above the pool handle's whole
+    // generation, so no two live entities, or an entity and its slot's next
+    // occupant, ever share an identity
+    if(proxy.layer == LAYER_PLAYER)
+    {
+        return (unsigned long long)proxy.index;
+    }
+    PoolHandle handle = (proxy.layer == LAYER_BULLET) ? bullets.HandleAt(proxy.index) : asteroids.HandleAt(proxy.index);
+    unsigned long long kind = (proxy.layer == LAYER_BULLET) ? 1 : 2;
+    return (kind << 62) | ((unsigned long long)handle.slot << 32) | handle.generation;
+}
+
+void Simulation::parallelFor(int count, int grain, const std::function<void(int, int)>& body)
+{
+    if(jobs)
+    {
+        jobs->ParallelFor(count, grain, body);
+    }
+    else if(count > 0)
+    {
+        body(0, count);
+    }
+}
+
+void Simulation::classifyCandidates(int begin, int end)
+{
+    for(int i = begin; i < end; i++)
+    {
+        const BroadphaseProxy& first = broadphase.GetProxy(candidatePairs[i].first);
+        const BroadphaseProxy& second = broadphase.GetProxy(candidatePairs[i].second);
+        // the asteroid is always the hull pushed out, matching the response below
+        const BroadphaseProxy& pushed = (first.layer == LAYER_ASTEROID) ? first : second;
+        const BroadphaseProxy& other = (first.layer == LAYER_ASTEROID) ? second : first;
+        SATPair& pair = candidateShapes[i];
+        const CollisionBounds& pushedBounds = proxyShape(pushed, pair.first, pair.firstAxes);
+        const CollisionBounds& otherBounds = proxyShape(other, pair.second, pair.secondAxes);
+        candidateAxes[i] = -1;
+        // both tiers enclose the hulls, so a rejection here is never a missed hit
+        if(!circlesOverlap(pushedBounds, otherBounds))
+        {
+            candidateTiers[i] = TIER_CIRCLE_REJECT;
+#ifdef DEBUG
+            std::pair<float, float> penetration;
+            assert(!CheckSATCollision(pair.first, pair.firstAxes, pair.second, pair.secondAxes, penetration));
+#endif
+            continue;
+        }
+        if(!boxesOverlap(pushedBounds, otherBounds))
+        {
+            candidateTiers[i] = TIER_BOUNDS_REJECT;
+#ifdef DEBUG
+            std::pair<float, float> penetration;
+            assert(!CheckSATCollision(pair.first, pair.firstAxes, pair.second, pair.secondAxes, penetration));
+#endif
+            continue;
+        }
+        SeparatingAxisEntry entry;
+        entry.key.first = proxyIdentity(pushed);
+        entry.key.second = proxyIdentity(other);
+        candidateKeys[i] = entry.key;
+        candidateTiers[i] = TIER_SAT;
+
+        // things drift a little each frame, so last frame's separating axis usually still separates
+        std::vector<SeparatingAxisEntry>::const_iterator cached = std::lower_bound(axisCache.begin(), axisCache.end(), entry);
+        if(cached != axisCache.end() && cached->key == entry.key)
+        {
+            candidateAxes[i] = cached->axis;
+            if(SeparatesOnAxis(pair, cached->axis))
+            {
+                candidateTiers[i] = TIER_CACHE_REJECT;
+#ifdef DEBUG
+                std::pair<float, float> penetration;
+                assert(!CheckSATCollision(pair.first, pair.firstAxes, pair.second, pair.secondAxes, penetration));
+#endif
+            }
+        }
+    }
+}
+
+void Simulation::narrowphase()
+{
+    // hulls only move in the Update pass after collision response, so every
+    // candidate can be tested up front before any of them is resolved
+    int count = (int)candidatePairs.size();
+    satHits.assign(count, 0);
+    satPenetrations.resize(count);
+    candidateTiers.resize(count);
+    candidateShapes.resize(count);
+    candidateKeys.resize(count);
+    candidateAxes.resize(count);
+    parallelFor(count, NARROWPHASE_JOB_GRAIN, [this](int begin, int end) { classifyCandidates(begin, end); });
+
+    satPairs.clear();
+    satCandidates.clear();
+    satKeys.clear();
+    nextAxisCache.clear();
+    narrowphaseStats.pairs += count;
+    for(int i = 0; i < count; i++)
+    {
+        switch(candidateTiers[i])
+        {
+            case TIER_CIRCLE_REJECT:
+                narrowphaseStats.circleRejects++;
+                break;
+            case TIER_BOUNDS_REJECT:
+                narrowphaseStats.boundsRejects++;
+                break;
+            case TIER_CACHE_REJECT:
+            {
+                narrowphaseStats.cachedAxes++;
+                narrowphaseStats.cacheHits++;
+                narrowphaseStats.satRejects++;
+                SeparatingAxisEntry entry;
+                entry.key = candidateKeys[i];
+                entry.axis = candidateAxes[i];
+                nextAxisCache.push_back(entry);
+                break;
+            }
+            case TIER_SAT:
+                if(candidateAxes[i] >= 0)
+                {
+                    narrowphaseStats.cachedAxes++;
+                }
+                satPairs.push_back(candidateShapes[i]);
+                satCandidates.push_back(i);
+                satKeys.push_back(candidateKeys[i]);
+                break;
+        }
+    }
+
+    int batch = (int)satPairs.size();
+    satBatchHits.resize(batch);
+    satBatchPenetrations.resize(batch);
+    satBatchAxes.resize(batch);
+    // each pair's result only depends on that pair, so the batch splits anywhere
+    parallelFor(batch, NARROWPHASE_JOB_GRAIN, [this](int begin, int end) {
+        CheckSATBatch(satPairs.data() + begin, end - begin, satBatchHits.data() + begin, satBatchPenetrations.data() + begin, satBatchAxes.data() + begin);
+    });
+#ifdef DEBUG
+    std::vector<unsigned char> referenceHits(batch);
+    std::vector<std::pair<float, float>> referencePenetrations(batch);
+    std::vector<int> referenceAxes(batch);
+    CheckSATBatchScalar(satPairs.data(), batch, referenceHits.data(), referencePenetrations.data(), referenceAxes.data());
+    for(int i = 0; i < batch; i++)
+    {
+        assert(satBatchHits[i] == referenceHits[i]);
+        assert(satBatchHits[i] ? satBatchPenetrations[i] == referencePenetrations[i] : satBatchAxes[i] == referenceAxes[i]);
+    }
+#endif
+    for(int i = 0; i < batch; i++)
+    {
+        int candidate = satCandidates[i];
+        satHits[candidate] = satBatchHits[i];
+        satPenetrations[candidate] = satBatchPenetrations[i];
+        if(!satBatchHits[i])
+        {
+            narrowphaseStats.satRejects++;
+            SeparatingAxisEntry entry;
+            entry.key = satKeys[i];
+            entry.axis = satBatchAxes[i];
+            nextAxisCache.push_back(entry);
+        }
+    }
+    std::sort(nextAxisCache.begin(), nextAxisCache.end());
+    axisCache.swap(nextAxisCache);
+}
+
+void Simulation::emit(SimulationEventType type, int player, glm::vec3 position)
+{
+    SimulationEvent event;
+    event.type = type;
+    event.player = player;
+    event.position = position;
+    events.push_back(event);
+}
+
+void Simulation::player2Enable()
+{
+    p2Enable = true;
+    player2.health = 5;
+    player1.position = glm::vec3(-0.25f, 0.0f, 0.0f);
+}
+
+void Simulation::asteroidInitialization()
+{
+    asteroids.Clear();
+    for(int i = 0; i < 5; i++)
+    {
+        asteroidCreation();
+    }
+}
+
+void Simulation::asteroidCreation()
+{
+    if(asteroids.Full())
+    {
+        return;
+    }
+    float posX = -1.77f;
+    float posY = -1.0f;
+    if(random.Range(0, 1) > 0.5f)
+    {
+        posX = random.Range(1.5f, 1.75f);
+    }
+    else
+    {
+        posX = random.Range(-1.75f, -1.5f);
+    }
+    if(random.Range(0, 1) > 0.5f)
+    {
+        posY = random.Range(0.8f, 0.95f);
+    }
+    else
+    {
+        posY = random.Range(-0.95f, -0.8f);
+    }
+    int index = (int) (random.Range(0, 3.9));
+    // draw in a fixed order; argument evaluation order would differ between compilers
+    float sizeX = random.Range(0.1f, 0.6f);
+    float sizeY = random.Range(0.1f, 1.0f);
+    float rotation = random.Range(0, 360);
+    float velocityX = random.Range(-0.75f, 0.55f);
+    float velocityY = random.Range(-0.55f, 0.75f);
+    asteroids.Acquire(Asteroid(glm::vec3(posX, posY, 0.0f), glm::vec3(sizeX, sizeY, 0.5f),
+                        rotation, glm::vec3(velocityX, velocityY, 0.0f), possibleIndices[index], possibleAxes[index]));
+}
+
+void Simulation::Reset()
+{
+    player1.health = 5;
+    player2.health = 5;
+    player2.position = glm::vec3(0.25f, 0.0f, 0.0f);
+    player2.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+    player2.rotation = 0.0f;
+    if(p2Enable)
+    {
+        player1.position = glm::vec3(-0.25f, 0.0f, 0.0f);
+    }
+    player1.position = glm::vec3(0.0f, 0.0f, 0.0f);
+    player1.rotation = 0.0f;
+    player1.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+    asteroids.Clear();
+    for(int i = 0; i < 5; i++)
+    {
+        asteroidCreation();
+    }
+}
+
+void Simulation::ProcessInput(const PlayerInput& player1Input, const PlayerInput& player2Input)
+{
+    player1.Process(player1Input);
+    player2.Process(player2Input);
+}
+
+void Simulation::shoot(Entity& entity)
+{
+    if(entity.shoot)
+    {
+        emit(SHOT_FIRED, entity.playerTag, entity.position);
+        bullets.Release(bulletHandles[bulletIndex]);
+        Entity bullet = bulletTemplate;
+        bullet.position = entity.position;
+        bullet.velocity = glm::vec3(cos(entity.rotation+glm::pi<float>()/2)*2.5f, sin(entity.rotation+glm::pi<float>()/2)*2.5f, 0.0f);
+        bullet.rotation = entity.rotation;
+        bullet.playerTag = entity.playerTag;
+        bullet.updateTransform();
+        bullet.storePrevious();
+        bulletHandles[bulletIndex] = bullets.Acquire(bullet);
+        bulletIndex++;
+        if(bulletIndex >= max_bullets)
+        {
+            bulletIndex = 0;
+        }
+        entity.shoot = false;
+    }
+}
+
+void Simulation::Update(float elapsed)
+{
+    timer += elapsed;
+    if(timer > random.Range(2, 4))
+    {
+        asteroidCreation();
+        timer = 0.0f;
+    }
+    broadphase.Clear();
+    insertProxy(player1.bounds, 1, LAYER_PLAYER, LAYER_ASTEROID);
+    if(p2Enable)
+    {
+        insertProxy(player2.bounds, 2, LAYER_PLAYER, LAYER_ASTEROID);
+    }
+    for(int i = 0; i < bullets.Size(); i++)
+    {
+        insertProxy(bullets[i].bounds, i, LAYER_BULLET, LAYER_ASTEROID);
+    }
+    // asteroids go in last so the second proxy of every pair is an asteroid
+    for(int i = 0; i < asteroids.Size(); i++)
+    {
+        insertProxy(asteroids[i].bounds, i, LAYER_ASTEROID, LAYER_PLAYER | LAYER_BULLET | LAYER_ASTEROID);
+    }
+    broadphase.FindPairs(candidatePairs, jobs);
+    narrowphaseStats.steps++;
+    narrowphaseStats.proxies += broadphase.stats.proxies;
+    narrowphaseStats.cellEntries += broadphase.stats.cellEntries;
+    narrowphaseStats.bruteForcePairs += broadphase.stats.bruteForcePairs;
+    narrowphase();
+    for(int i = 0; i < candidatePairs.size(); i++)
+    {
+        if(!satHits[i])
+        {
+            continue;
+        }
+        const BroadphaseProxy& first = broadphase.GetProxy(candidatePairs[i].first);
+        const BroadphaseProxy& second = broadphase.GetProxy(candidatePairs[i].second);
+        std::pair<float,float> penetration = satPenetrations[i];
+        if(first.layer == LAYER_PLAYER)
+        {
+            Asteroid& check = asteroids[second.index];
+            Entity& player = (first.index == 1) ? player1 : player2;
+            if(check.isEnable)
+            {
+                player.collisionUpdate();
+                emit(PLAYER_HIT, player.playerTag, player.position);
+                check.isEnable = false;
+            }
+        }
+        else if(first.layer == LAYER_BULLET)
+        {
+            Asteroid& check = asteroids[second.index];
+            Entity& bullet = bullets[first.index];
+            if(check.isEnable && bullet.isEnable)
+            {
+                if(bullet.playerTag == 1)
+                {
+                    player1Score += 10;
+                }
+                if(bullet.playerTag == 2)
+                {
+                    player2Score += 10;
+                }
+                check.isEnable = false;
+                bullet.collisionUpdate();
+            }
+        }
+        else
+        {
+            Asteroid& check = asteroids[first.index];
+            Asteroid& asteroid = asteroids[second.index];
+            if(check.isEnable && asteroid.isEnable)
+            {
+                check.collisionUpdate(penetration, 1);
+                asteroid.collisionUpdate(penetration, -1);
+                float xPos = check.position.x - penetration.first*50*check.size.x;
+                float yPos = check.position.y - penetration.second*50*check.size.y;
+                emit(ASTEROIDS_COLLIDED, -1, glm::vec3(xPos, yPos, 0.0f));
+            }
+        }
+    }
+    releaseDisabled(asteroids);
+    player1.Update(elapsed);
+    if(player1.health <= 0)
+    {
+        emit(PLAYER_DIED, 1, player1.position);
+        emit(GAME_OVER, 1, player1.position);
+        Reset();
+    }
+    if(p2Enable)
+    {
+        player2.Update(elapsed);
+        if(player2.health <= 0)
+        {
+            emit(PLAYER_DIED, 2, player2.position);
+            emit(GAME_OVER, 2, player2.position);
+            Reset();
+        }
+    }
+    for(Asteroid& asteroid : asteroids)
+    {
+        asteroid.Update(elapsed);
+    }
+    if(asteroids.Size() == 0)
+    {
+        emit(GAME_OVER, -1, glm::vec3(0.0f, 0.0f, 0.0f));
+        Reset();
+    }
+    for(Entity& bullet : bullets)
+    {
+        bullet.Update(elapsed);
+    }
+    releaseDisabled(bullets);
+}
+
+void Simulation::Apply(SimulationCommand command)
+{
+    switch(command)
+    {
+        case COMMAND_ENABLE_PLAYER2:
+            player2Enable();
+            break;
+        case COMMAND_NEW_GAME:
+            player1Score = 0;
+            player2Score = 0;
+            break;
+        case COMMAND_RETURN_TO_START:
+            player1Score = 0;
+            player2Score = 0;
+            p2Enable = false;
+            break;
+    }
+}
+
+PlayerInput Simulation::decodeInput(unsigned int bits) const
+{
+    PlayerInput input;
+    input.forward = (bits & INPUT_FORWARD) != 0;
+    input.backward = (bits & INPUT_BACKWARD) != 0;
+    input.rotateLeft = (bits & INPUT_ROTATE_LEFT) != 0;
+    input.rotateRight = (bits & INPUT_ROTATE_RIGHT) != 0;
+    return input;
+}
+
+void Simulation::storePrevious()
+{
+    player1.storePrevious();
+    player2.storePrevious();
+    for(Entity& bullet : bullets)
+    {
+        bullet.storePrevious();
+    }
+    for(Asteroid& asteroid : asteroids)
+    {
+        asteroid.storePrevious();
+    }
+}
+
+void Simulation::Step(unsigned int inputBits, float elapsed)
+{
+    storePrevious();
+    unsigned int player2Bits = inputBits >> INPUT_PLAYER_BITS;
+    if(inputBits & INPUT_SHOOT)
+    {
+        shoot(player1);
+    }
+    if(player2Bits & INPUT_SHOOT)
+    {
+        shoot(player2);
+    }
+    ProcessInput(decodeInput(inputBits), decodeInput(player2Bits));
+    Update(elapsed);
+}
+
+static void hashBytes(unsigned int& hash, const void* data, size_t length)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+}
+
+static void hashEntity(unsigned int& hash, const Entity& entity)
+{
+    hashBytes(hash, &entity.position, sizeof(entity.position));
+    hashBytes(hash, &entity.velocity, sizeof(entity.velocity));
+    hashBytes(hash, &entity.rotation, sizeof(entity.rotation));
+    hashBytes(hash, &entity.health, sizeof(entity.health));
+}
+
+unsigned int Simulation::StateHash() const
+{
+    unsigned int hash = 2166136261u;
+    hashEntity(hash, player1);
+    hashEntity(hash, player2);
+    hashBytes(hash, &player1Score, sizeof(player1Score));
+    hashBytes(hash, &player2Score, sizeof(player2Score));
+    hashBytes(hash, &p2Enable, sizeof(p2Enable));
+    hashBytes(hash, &timer, sizeof(timer));
+    hashBytes(hash, &random.state, sizeof(random.state));
+    for(const Entity& bullet : bullets)
+    {
+        hashBytes(hash, &bullet.position, sizeof(bullet.position));
+    }
+    for(const Asteroid& asteroid : asteroids)
+    {
+        hashBytes(hash, &asteroid.position, sizeof(asteroid.position));
+    }
+    return hash;
+}
+
+void hullBounds(HullSpan hull, glm::vec2& minimum, glm::vec2& maximum)
+{
+    minimum = glm::vec2(hull.points[0], hull.points[1]);
+    maximum = minimum;
+    for(int i = 1; i < hull.count; i++)
+    {
+        minimum.x = fmin(minimum.x, hull.points[i*2]);
+        minimum.y = fmin(minimum.y, hull.points[i*2+1]);
+        maximum.x = fmax(maximum.x, hull.points[i*2]);
+        maximum.y = fmax(maximum.y, hull.points[i*2+1]);
+    }
+}
+
+bool circlesOverlap(const CollisionBounds& first, const CollisionBounds& second)
+{
+    glm::vec2 offset = first.center - second.center;
+    float reach = first.radius + second.radius;
+    return offset.x*offset.x + offset.y*offset.y <= reach*reach;
+}
+
+bool boxesOverlap(const CollisionBounds& first, const CollisionBounds& second)
+{
+    return first.minimum.x <= second.maximum.x && second.minimum.x <= first.maximum.x &&
+           first.minimum.y <= second.maximum.y && second.minimum.y <= first.maximum.y;
+}
+
+glm::mat4 interpolatedTransform(glm::vec3 previousPosition, float previousRotation, glm::vec3 position, float rotation, float alpha)
+{
+    glm::vec3 offset = position - previousPosition;
+    if(offset.x*offset.x + offset.y*offset.y > INTERPOLATION_SNAP_DISTANCE*INTERPOLATION_SNAP_DISTANCE ||
+       fabsf(rotation - previousRotation) > INTERPOLATION_SNAP_ROTATION)
+    {
+        alpha = 1.0f;
+    }
+    glm::mat4 matrix = glm::mat4(1.0f);
+    matrix = glm::translate(matrix, previousPosition + offset * alpha);
+    matrix = glm::rotate(matrix, previousRotation + (rotation - previousRotation) * alpha, glm::vec3(0.0f, 0.0f, 1.0f));
+    return matrix;
+}
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <math.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/constants.hpp"
+#include "Collision.h"
+#include "Broadphase.h"
+#include "ObjectPool.h"
+#include "TextureAtlas.h"
+#include "Utilities.h"
+
+// Asteroids game rules with no SDL, GL or audio dependency. Anything the
+// player should see or hear is reported through events; the front end in
+// main.cpp turns those into sounds, particles and screen changes.
+
+// room for the 2000-body stress scene, see tools/headless.cpp
+#define MAX_ASTEROIDS 2048
+// moving or turning farther than this in one step is a wrap, respawn or reset,
+// drawn without blending
+#define INTERPOLATION_SNAP_DISTANCE 0.5f
+#define INTERPOLATION_SNAP_ROTATION 1.0f
+// candidate pairs, and SAT batch pairs, handed to one job
+#define NARROWPHASE_JOB_GRAIN 64
+
+enum EntityType { PLAYER, BULLET, ASTEROID };
+
+enum SimulationEventType { SHOT_FIRED, PLAYER_HIT, PLAYER_DIED, ASTEROIDS_COLLIDED, GAME_OVER };
+
+struct SimulationEvent
+{
+    SimulationEventType type;
+    int player;
+    glm::vec3 position;
+};
+
+// One bit per key for both players; what a replay stores for every fixed step.
+enum InputBits
+{
+    INPUT_FORWARD = 1 << 0,
+    INPUT_BACKWARD = 1 << 1,
+    INPUT_ROTATE_LEFT = 1 << 2,
+    INPUT_ROTATE_RIGHT = 1 << 3,
+    INPUT_SHOOT = 1 << 4,
+    INPUT_PLAYER_BITS = 5
+};
+
+// Menu actions that change the simulation between steps.
+enum SimulationCommand { COMMAND_ENABLE_PLAYER2, COMMAND_NEW_GAME, COMMAND_RETURN_TO_START };
+
+struct PlayerInput
+{
+    PlayerInput() : forward(false), backward(false), rotateLeft(false), rotateRight(false) {}
+    bool forward;
+    bool backward;
+    bool rotateLeft;
+    bool rotateRight;
+};
+
+// Half extents of a sprite quad; the collision hull of players and bullets is this quad.
+struct SpriteExtents
+{
+    SpriteExtents() : halfWidth(0.0f), halfHeight(0.0f) {}
+    SpriteExtents(float halfWidth, float halfHeight) : halfWidth(halfWidth), halfHeight(halfHeight) {}
+    // matches the quad SheetSprite builds for a region drawn at the given size
+    static SpriteExtents FromRegion(AtlasRegion region, float size)
+    {
+        return SpriteExtents(0.5f * size * region.width / region.height, 0.5f * size);
+    }
+    float halfWidth;
+    float halfHeight;
+};
+
+void hullBounds(HullSpan hull, glm::vec2& minimum, glm::vec2& maximum);
+// Translation and rotation blended alpha of the way from the previous step's to the current one's.
+glm::mat4 interpolatedTransform(glm::vec3 previousPosition, float previousRotation, glm::vec3 position, float rotation, float alpha);
+
+// Conservative bounds kept next to a hull and refreshed with it, so most pairs
+// can be rejected without any SAT work.
+struct CollisionBounds
+{
+    CollisionBounds() : center(0.0f), radius(0.0f), minimum(0.0f), maximum(0.0f) {}
+    glm::vec2 center;
+    // farthest hull vertex from center
+    float radius;
+    glm::vec2 minimum;
+    glm::vec2 maximum;
+};
+
+bool circlesOverlap(const CollisionBounds& first, const CollisionBounds& second);
+bool boxesOverlap(const CollisionBounds& first, const CollisionBounds& second);
+
+// Running totals over the life of a Simulation.
+struct NarrowphaseStats
+{
+    NarrowphaseStats() : steps(0), proxies(0), cellEntries(0), bruteForcePairs(0), pairs(0), circleRejects(0), boundsRejects(0), satRejects(0),
+        cachedAxes(0), cacheHits(0) {}
+    unsigned long long steps;
+    // the broadphase's side: proxies inserted, the grid cells they covered, and
+    // the pairs an all-against-all loop with the same layer masks would test
+    unsigned long long proxies;
+    unsigned long long cellEntries;
+    unsigned long long bruteForcePairs;
+    // broadphase candidates handed to the narrowphase
+    unsigned long long pairs;
+    // candidates rejected by each tier in turn: bounding circles, world AABBs,
+    // then SAT (including by a cached axis); whatever is left collided
+    unsigned long long circleRejects;
+    unsigned long long boundsRejects;
+    unsigned long long satRejects;
+    // candidates that were also separated last frame, with their axis remembered
+    unsigned long long cachedAxes;
+    // of those, the ones the remembered axis still separated, skipping the full test
+    unsigned long long cacheHits;
+};
+
+// How far a candidate pair got through the narrowphase before it was settled.
+enum NarrowphaseTier { TIER_CIRCLE_REJECT, TIER_BOUNDS_REJECT, TIER_CACHE_REJECT, TIER_SAT };
+
+// A candidate pair as both entities' full identities: kind, pool slot and
+// generation of the pushed side, then of the other.
+struct ProxyPairKey
+{
+    unsigned long long first;
+    unsigned long long second;
+    bool operator<(const ProxyPairKey& other) const
+    {
+        return first < other.first || (first == other.first && second < other.second);
+    }
+    bool operator==(const ProxyPairKey& other) const
+    {
+        return first == other.first && second == other.second;
+    }
+};
+
+// Last frame's separating axis for a pair, keyed on both entities' identities.
+struct SeparatingAxisEntry
+{
+    ProxyPairKey key;
+    int axis;
+    bool operator<(const SeparatingAxisEntry& other) const
+    {
+        return key < other.key;
+    }
+};
+
+class Entity{
+public:
+    Entity(){}
+    Entity(glm::vec3 position, glm::vec3 size, float rotation, glm::vec3 friction, EntityType type) : position(position), size(size), rotation(rotation), friction(friction), type(type)
+    {
+        matrix = glm::mat4(1.0f);
+        matrix = glm::scale(matrix, size);
+        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+        matrix = glm::translate(matrix, position);
+        glm::vec3 defaultSet = glm::vec3(0.0f, 0.0f, 0.0f);
+        velocity = defaultSet;
+        acceleration = defaultSet;
+        rotateAmount = 0.0f;
+        playerTag = -1;
+        shoot = false;
+        isEnable = true;
+        storePrevious();
+        if(type == PLAYER)
+        {
+            matrix = glm::mat4(1.0f);
+            moveSpeed = 0.75f;
+            rotationSpeed = moveSpeed*5;
+            time = 0.0f;
+            health = 5;
+            playerTag = 1;
+        }
+    }
+    void setEdgeSet(SpriteExtents extents)
+    {
+        edgeSet.clear();
+        edgeSet.push_back(glm::vec4(-extents.halfWidth, -extents.halfHeight, 1.0f, 1.0f));
+        edgeSet.push_back(glm::vec4(extents.halfWidth, -extents.halfHeight, 1.0f, 1.0f));
+        edgeSet.push_back(glm::vec4(extents.halfWidth, extents.halfHeight, 1.0f, 1.0f));
+        edgeSet.push_back(glm::vec4(-extents.halfWidth, extents.halfHeight, 1.0f, 1.0f));
+        hull.resize(edgeSet.size()*2);
+        float corners[] = { -extents.halfWidth, -extents.halfHeight, extents.halfWidth, -extents.halfHeight,
+                            extents.halfWidth, extents.halfHeight, -extents.halfWidth, extents.halfHeight };
+        axes.clear();
+        BuildHullAxes(corners, 4, axes);
+        worldAxes.resize(axes.size());
+        bounds.radius = sqrtf(extents.halfWidth*extents.halfWidth + extents.halfHeight*extents.halfHeight);
+        updateHull();
+    }
+    void updateHull()
+    {
+        for(int i = 0; i < edgeSet.size(); i++)
+        {
+            glm::vec4 transformed = matrix * edgeSet[i];
+            hull[i*2] = transformed.x;
+            hull[i*2+1] = transformed.y;
+        }
+        RotateHullAxes(axes.data(), (int)axes.size()/2, rotation, worldAxes.data());
+        bounds.center = glm::vec2(position.x, position.y);
+        hullBounds(hullSpan(), bounds.minimum, bounds.maximum);
+    }
+    HullSpan hullSpan() const
+    {
+        return HullSpan(hull.data(), (int)hull.size()/2);
+    }
+    AxisSpan axisSpan() const
+    {
+        return AxisSpan(worldAxes.data(), (int)worldAxes.size()/2);
+    }
+    void Update(float elapsed)
+    {
+        matrix = glm::mat4(1.0f);
+        velocity.x = lerp(velocity.x, 0.0f, friction.x * elapsed);
+        velocity.y = lerp(velocity.y, 0.0f, friction.y * elapsed);
+        velocity.x += acceleration.x * elapsed;
+        velocity.y += acceleration.y * elapsed;
+        position.x += velocity.x * elapsed;
+        position.y += velocity.y * elapsed;
+        position.z = 0.0f;
+        if(type == PLAYER)
+        {
+            time += elapsed;
+            if(time >= 1.0f)
+            {
+                shoot = true;
+                time = 0.0f;
+            }
+            if(position.x < -1.8f)
+            {
+                position.x = 1.75f;
+            }
+            if(position.x > 1.8f)
+            {
+                position.x = -1.75f;
+            }
+            if(position.y < -1.01f)
+            {
+                position.y = 0.9f;
+            }
+            if(position.y > 1.01f)
+            {
+                position.y = -0.9f;
+            }
+        }
+        if(type == BULLET)
+        {
+            if(position.x < -1.85f || position.x > 1.85f || position.y < -1.1f || position.y > 1.1f)
+            {
+                isEnable = false;
+            }
+        }
+        rotateAmount = rotateAmount * (3.1415926585 / 180.0f);
+        rotation += rotateAmount;
+        updateTransform();
+    }
+    // the current state becomes the start of the next step's interpolation
+    void storePrevious()
+    {
+        previousPosition = position;
+        previousRotation = rotation;
+    }
+    glm::mat4 renderMatrix(float alpha) const
+    {
+        return interpolatedTransform(previousPosition, previousRotation, position, rotation, alpha);
+    }
+    void updateTransform()
+    {
+        matrix = glm::mat4(1.0f);
+        matrix = glm::translate(matrix, position);
+        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+        updateHull();
+    }
+    void Process(const PlayerInput& input)
+    {
+        if(input.forward)
+        {
+            velocity = glm::vec3(cos(rotation+glm::pi<float>()/2)*moveSpeed, sin(rotation+glm::pi<float>()/2)*moveSpeed, 0.0f);
+        }
+        if(input.backward)
+        {
+            velocity = glm::vec3(cos(rotation+glm::pi<float>()/2)*-moveSpeed, sin(rotation+glm::pi<float>()/2)*-moveSpeed, 0.0f);
+        }
+        if(input.rotateLeft)
+        {
+            rotateAmount += rotationSpeed;
+        }
+        if(input.rotateRight)
+        {
+            rotateAmount -= rotationSpeed;
+        }
+        if(rotation > 360)
+        {
+            rotation = 0;
+        }
+    }
+    void collisionUpdate()
+    {
+        if(type == PLAYER)
+        {
+            health--;
+        }
+        if(type == BULLET)
+        {
+            isEnable = false;
+        }
+    }
+    glm::mat4 matrix;
+    glm::vec3 position;
+    glm::vec3 size;
+    float rotation;
+    // transform at the end of the previous step, for render interpolation
+    glm::vec3 previousPosition;
+    float previousRotation;
+    float rotateAmount;
+    float moveSpeed;
+    float rotationSpeed;
+
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+    glm::vec3 friction;
+
+    std::vector<glm::vec4> edgeSet;
+    std::vector<float> hull;
+    // unit separating axes in model space, and rotated with the entity
+    std::vector<float> axes;
+    std::vector<float> worldAxes;
+    CollisionBounds bounds;
+
+    int health;
+    float time;
+    bool shoot;
+    bool isEnable;
+
+    EntityType type;
+    int playerTag;
+
+private:
+};
+
+class Asteroid : public std::iterator<std::input_iterator_tag, Asteroid>
+{
+public:
+    Asteroid(glm::vec3 position, glm::vec3 size, float rotation, glm::vec3 velocity, const std::vector<float>& indices, const std::vector<float>& templateAxes) : position(position), size(size), rotation(rotation), velocity(velocity)
+    {
+        // same transform Update builds, so the first frame's hull matches the axes
+        matrix = glm::mat4(1.0f);
+        matrix = glm::translate(matrix, position);
+        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+        ScaleHullAxes(templateAxes.data(), (int)templateAxes.size()/2, size.x, size.y, axes);
+        worldAxes.resize(axes.size());
+        for(float addIndex : indices)
+        {
+            index.push_back(addIndex);
+        }
+        for(int mod = 0; mod < index.size(); mod+=2)
+        {
+            index[mod] *= size.x;
+            index[mod+1] *= size.y;
+        }
+        isEnable = true;
+        storePrevious();
+        setEdgeSet();
+    }
+    void storePrevious()
+    {
+        previousPosition = position;
+        previousRotation = rotation;
+    }
+    glm::mat4 renderMatrix(float alpha) const
+    {
+        return interpolatedTransform(previousPosition, previousRotation, position, rotation, alpha);
+    }
+    void Update(float elapsed)
+    {
+        matrix = glm::mat4(1.0f);
+        position.x += velocity.x * elapsed;
+        position.y += velocity.y * elapsed;
+        if(position.x < -1.8f)
+        {
+            position.x = 1.75f;
+        }
+        if(position.x > 1.8f)
+        {
+            position.x = -1.75f;
+        }
+        if(position.y < -1.01f)
+        {
+            position.y = 0.9f;
+        }
+        if(position.y > 1.01f)
+        {
+            position.y = -0.9f;
+        }
+        matrix = glm::translate(matrix, position);
+        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+        updateHull();
+    }
+    void setEdgeSet()
+    {
+        bounds.radius = 0.0f;
+        for(int add = 0; add < index.size(); add += 2)
+        {
+            edgeSet.push_back(glm::vec4(index[add], index[add+1], 1.0f, 1.0f));
+            bounds.radius = fmaxf(bounds.radius, sqrtf(index[add]*index[add] + index[add+1]*index[add+1]));
+        }
+        hull.resize(edgeSet.size()*2);
+        updateHull();
+    }
+    void updateHull()
+    {
+        for(int i = 0; i < edgeSet.size(); i++)
+        {
+            glm::vec4 transformed = matrix * edgeSet[i];
+            hull[i*2] = transformed.x;
+            hull[i*2+1] = transformed.y;
+        }
+        RotateHullAxes(axes.data(), (int)axes.size()/2, rotation, worldAxes.data());
+        bounds.center = glm::vec2(position.x, position.y);
+        hullBounds(hullSpan(), bounds.minimum, bounds.maximum);
+    }
+    HullSpan hullSpan() const
+    {
+        return HullSpan(hull.data(), (int)hull.size()/2);
+    }
+    AxisSpan axisSpan() const
+    {
+        return AxisSpan(worldAxes.data(), (int)worldAxes.size()/2);
+    }
+    void collisionUpdate(std::pair<float, float> penetration, int factor)
+    {
+        position.x += penetration.first * 0.5f * factor;
+        position.y += penetration.second * 0.5f * factor;
+        //penetration contains overlap - penetration.first * 0.5 for x, penetration.second *0.5 on y
+        // and you move the other entity by negative penetration.first *0.5 and negative penetration.second *0.5
+    }
+    std::vector<glm::vec4> edgeSet;
+    std::vector<float> hull;
+    std::vector<float> axes;
+    std::vector<float> worldAxes;
+    CollisionBounds bounds;
+    std::vector<float> index;
+    glm::mat4 matrix;
+    glm::vec3 position;
+    glm::vec3 size;
+    float rotation;
+    // transform at the end of the previous step, for render interpolation
+    glm::vec3 previousPosition;
+    float previousRotation;
+    float rotateAmount;
+    float moveSpeed;
+    float rotationSpeed;
+
+    bool isEnable;
+
+    glm::vec3 velocity;
+
+    int health;
+};
+
+bool operator==(Asteroid& left, Asteroid& right);
+bool operator!=(Asteroid& left, Asteroid& right);
+
+class Simulation
+{
+public:
+    Simulation() : jobs(nullptr) {}
+    Simulation(SpriteExtents player1Extents, SpriteExtents player2Extents, SpriteExtents bulletExtents, unsigned int seed);
+
+    void player2Enable();
+    void asteroidInitialization();
+    void asteroidCreation();
+    void Reset();
+    void ProcessInput(const PlayerInput& player1Input, const PlayerInput& player2Input);
+    void shoot(Entity& entity);
+    void Update(float elapsed);
+    void Apply(SimulationCommand command);
+    // Shots, then movement, then one Update; live play and replays both step through here.
+    void Step(unsigned int inputBits, float elapsed);
+    // Hash of everything that decides future frames, for checking replays.
+    unsigned int StateHash() const;
+
+    Entity player1;
+    Entity player2;
+    int player1Score;
+    int player2Score;
+    ObjectPool<Asteroid> asteroids;
+    int max_bullets;
+    int bulletIndex;
+    ObjectPool<Entity> bullets;
+    // ring of the most recent shots; a new shot recycles the oldest one if it is still flying
+    std::vector<PoolHandle> bulletHandles;
+    Entity bulletTemplate;
+    bool p2Enable;
+    float timer;
+    Random random;
+    std::vector<std::vector<float>> possibleIndices;
+    // unit separating axes of each outline in possibleIndices
+    std::vector<std::vector<float>> possibleAxes;
+    SpatialHash broadphase;
+    std::vector<std::pair<int, int>> candidatePairs;
+    // Per candidate pair. The tier tests run in parallel and only write these,
+    // then one in-order pass gathers them, so results never depend on threading.
+    std::vector<unsigned char> candidateTiers;
+    std::vector<SATPair> candidateShapes;
+    std::vector<ProxyPairKey> candidateKeys;
+    // remembered separating axis, or -1
+    std::vector<int> candidateAxes;
+    std::vector<unsigned char> satHits;
+    std::vector<std::pair<float, float>> satPenetrations;
+    // pairs the axis cache could not settle, tested together in one batch
+    std::vector<SATPair> satPairs;
+    std::vector<int> satCandidates;
+    std::vector<ProxyPairKey> satKeys;
+    std::vector<unsigned char> satBatchHits;
+    std::vector<std::pair<float, float>> satBatchPenetrations;
+    std::vector<int> satBatchAxes;
+    // sorted by key; rebuilt every frame from the pairs that separated, so pairs
+    // that leave the broadphase drop out on their own
+    std::vector<SeparatingAxisEntry> axisCache;
+    std::vector<SeparatingAxisEntry> nextAxisCache;
+    NarrowphaseStats narrowphaseStats;
+    // filled by Update and shoot; the front end clears it once handled
+    std::vector<SimulationEvent> events;
+    // Splits the broadphase and narrowphase across threads when set; a null
+    // pool runs everything on the calling thread with identical results.
+    JobSystem* jobs;
+
+private:
+    void storePrevious();
+    void insertProxy(const CollisionBounds& bounds, int index, unsigned int layer, unsigned int mask);
+    const CollisionBounds& proxyShape(const BroadphaseProxy& proxy, HullSpan& hull, AxisSpan& axes) const;
+    unsigned long long proxyIdentity(const BroadphaseProxy& proxy) const;
+    void narrowphase();
+    void classifyCandidates(int begin, int end);
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
+    void emit(SimulationEventType type, int player, glm::vec3 position);
+    PlayerInput decodeInput(unsigned int bits) const;
+    template <typename T>
+    void releaseDisabled(ObjectPool<T>& pool)
+    {
+        // walking backwards means the object swapped into a released slot has already been checked
+        for(int i = (int)pool.Size() - 1; i >= 0; i--)
+        {
+            if(!pool[i].isEnable)
+            {
+                pool.ReleaseAt(i);
+            }
+        }
+    }
+};
@@ -0,0 +1,60 @@
+#include "SoundBank.h"
+#include <iostream>
+
+SoundBank::SoundBank() : decodes(0) {}
+
+Mix_Chunk *SoundBank::Acquire(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::map<std::string, Entry>::iterator found = sounds.find(path);
+        if(found != sounds.end()) {
+            found->second.references++;
+            return found->second.chunk;
+        }
+    }
+    Mix_Chunk *chunk = Mix_LoadWAV(path.c_str());
+    if(!chunk) {
+        std::cout << "Unable to load sound " << path << ": " << Mix_GetError() << "\n";
+        return NULL;
+    }
+    decodes++;
+    std::lock_guard<std::mutex> guard(lock);
+    // another thread may have decoded the same file meanwhile; keep the first
+    std::map<std::string, Entry>::iterator found = sounds.find(path);
+    if(found != sounds.end()) {
+        Mix_FreeChunk(chunk);
+        found->second.references++;
+        return found->second.chunk;
+    }
+    Entry entry;
+    entry.chunk = chunk;
+    entry.references = 1;
+    sounds[path] = entry;
+    return chunk;
+}
+
+void SoundBank::Release(Mix_Chunk *chunk) {
+    std::lock_guard<std::mutex> guard(lock);
+    for(std::map<std::string, Entry>::iterator it = sounds.begin(); it != sounds.end(); ++it) {
+        if(it->second.chunk == chunk) {
+            if(--it->second.references == 0) {
+                Mix_FreeChunk(chunk);
+                sounds.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+void SoundBank::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    for(std::map<std::string, Entry>::iterator it = sounds.begin(); it != sounds.end(); ++it) {
+        Mix_FreeChunk(it->second.chunk);
+    }
+    sounds.clear();
+}
+
+int SoundBank::LoadedCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return (int)sounds.size();
+}
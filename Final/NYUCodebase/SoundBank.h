@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <SDL_mixer.h>
+
+// Decoded sound effects shared by path. Asking for the same file twice hands
+// back the same Mix_Chunk instead of decoding and storing the PCM again.
+// Safe to use from several threads; decoding happens outside the lock, so
+// asset workers can load different files at the same time.
+class SoundBank {
+    public:
+        SoundBank();
+
+        // Decodes path on first use; NULL if it could not be loaded. Each
+        // successful Acquire needs a matching Release.
+        Mix_Chunk *Acquire(const std::string &path);
+        // Drops one reference; the chunk is freed with the last one.
+        void Release(Mix_Chunk *chunk);
+        // Frees everything still loaded. Call before the audio device closes.
+        void Clear();
+
+        int LoadedCount() const;
+        // files actually decoded, as opposed to served from the bank
+        std::atomic<unsigned int> decodes;
+
+    private:
+        SoundBank(const SoundBank &);
+        SoundBank &operator=(const SoundBank &);
+
+        struct Entry {
+            Mix_Chunk *chunk;
+            int references;
+        };
+        mutable std::mutex lock;
+        std::map<std::string, Entry> sounds;
+};
@@ -0,0 +1,138 @@
+#include "TextCache.h"
+#include "glm/mat4x4.hpp"
+#include <algorithm>
+
+TextCache::TextCache() : drawCalls(0), runsBuilt(0), uploaded(false), vbo(0) {}
+
+TextCache::~TextCache() {
+    if(vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+    }
+}
+
+bool TextCache::RunKey::operator<(const RunKey &other) const {
+    if(fontTexture != other.fontTexture) {
+        return fontTexture < other.fontTexture;
+    }
+    if(size != other.size) {
+        return size < other.size;
+    }
+    if(spacing != other.spacing) {
+        return spacing < other.spacing;
+    }
+    return text < other.text;
+}
+
+bool TextCache::Placement::operator==(const Placement &other) const {
+    return fontTexture == other.fontTexture && run == other.run && x == other.x && y == other.y;
+}
+
+void TextCache::Begin() {
+    placements.clear();
+    runsBuilt = 0;
+    // strings like scores keep producing new runs; start over rather than grow forever
+    if(runs.size() > TEXT_CACHE_MAX_RUNS) {
+        runIndex.clear();
+        runs.clear();
+        lastPlacements.clear();
+    }
+}
+
+int TextCache::FindRun(const RunKey &key) {
+    std::map<RunKey, int>::iterator found = runIndex.find(key);
+    if(found != runIndex.end()) {
+        return found->second;
+    }
+    float character_size = 1.0f / 16.0f;
+    std::vector<float> run;
+    run.reserve(key.text.size() * 24);
+    for(size_t i = 0; i < key.text.size(); i++) {
+        int spriteIndex = (int)(unsigned char)key.text[i];
+        float texture_x = (float)(spriteIndex % 16) / 16.0f;
+        float texture_y = (float)(spriteIndex / 16) / 16.0f;
+        float offset = (key.size + key.spacing) * i;
+        float quad[] = {
+            offset + (-0.5f * key.size), 0.5f * key.size, texture_x, texture_y,
+            offset + (-0.5f * key.size), -0.5f * key.size, texture_x, texture_y + character_size,
+            offset + (0.5f * key.size), 0.5f * key.size, texture_x + character_size, texture_y,
+            offset + (0.5f * key.size), -0.5f * key.size, texture_x + character_size, texture_y + character_size,
+            offset + (0.5f * key.size), 0.5f * key.size, texture_x + character_size, texture_y,
+            offset + (-0.5f * key.size), -0.5f * key.size, texture_x, texture_y + character_size
+        };
+        run.insert(run.end(), quad, quad + 24);
+    }
+    int id = (int)runs.size();
+    runs.push_back(run);
+    runIndex[key] = id;
+    runsBuilt++;
+    return id;
+}
+
+void TextCache::Draw(int fontTexture, const std::string &text, float size, float spacing, glm::vec3 position) {
+    RunKey key;
+    key.fontTexture = fontTexture;
+    key.text = text;
+    key.size = size;
+    key.spacing = spacing;
+    Placement placement;
+    placement.fontTexture = fontTexture;
+    placement.run = FindRun(key);
+    placement.x = position.x;
+    placement.y = position.y;
+    placements.push_back(placement);
+}
+
+void TextCache::End(ShaderProgram &program) {
+    drawCalls = 0;
+    uploaded = false;
+    if(placements.empty()) {
+        return;
+    }
+    if(vbo == 0) {
+        glGenBuffers(1, &vbo);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if(placements != lastPlacements) {
+        lastPlacements = placements;
+        // group by font, keeping submission order inside a font
+        std::stable_sort(placements.begin(), placements.end(), [](const Placement &a, const Placement &b) {
+            return a.fontTexture < b.fontTexture;
+        });
+        vertexData.clear();
+        ranges.clear();
+        for(const Placement &placement : placements) {
+            if(ranges.empty() || ranges.back().fontTexture != placement.fontTexture) {
+                FontRange range;
+                range.fontTexture = placement.fontTexture;
+                range.first = (int)(vertexData.size() / 4);
+                range.count = 0;
+                ranges.push_back(range);
+            }
+            const std::vector<float> &run = runs[placement.run];
+            for(size_t i = 0; i < run.size(); i += 4) {
+                vertexData.push_back(run[i] + placement.x);
+                vertexData.push_back(run[i+1] + placement.y);
+                vertexData.push_back(run[i+2]);
+                vertexData.push_back(run[i+3]);
+            }
+            ranges.back().count = (int)(vertexData.size() / 4) - ranges.back().first;
+        }
+        glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW);
+        uploaded = true;
+    }
+
+    program.SetModelMatrix(glm::mat4(1.0f));
+    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(program.positionAttribute);
+    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(program.texCoordAttribute);
+    for(const FontRange &range : ranges) {
+        glBindTexture(GL_TEXTURE_2D, range.fontTexture);
+        glDrawArrays(GL_TRIANGLES, range.first, range.count);
+        drawCalls++;
+    }
+    glDisableVertexAttribArray(program.positionAttribute);
+    glDisableVertexAttribArray(program.texCoordAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "glm/vec3.hpp"
+#include "ShaderProgram.h"
+
+#define TEXT_CACHE_MAX_RUNS 256
+
+// Lays out strings from a 16x16 bitmap font once and keeps the glyph quads
+// around. Each frame the strings submitted between Begin() and End() are merged
+// into one vertex buffer per font; if the frame submits exactly what the last
+// one did, the buffer already on the GPU is drawn again without re-uploading.
+class TextCache {
+    public:
+        TextCache();
+        ~TextCache();
+
+        void Begin();
+        void Draw(int fontTexture, const std::string &text, float size, float spacing, glm::vec3 position);
+        void End(ShaderProgram &program);
+
+        // counters for the last End()
+        int drawCalls;
+        int runsBuilt;
+        bool uploaded;
+
+    private:
+        TextCache(const TextCache &other);
+        TextCache &operator=(const TextCache &other);
+
+        struct RunKey {
+            int fontTexture;
+            std::string text;
+            float size;
+            float spacing;
+            bool operator<(const RunKey &other) const;
+        };
+
+        struct Placement {
+            int fontTexture;
+            int run;
+            float x;
+            float y;
+            bool operator==(const Placement &other) const;
+        };
+
+        struct FontRange {
+            int fontTexture;
+            int first;
+            int count;
+        };
+
+        int FindRun(const RunKey &key);
+
+        std::map<RunKey, int> runIndex;
+        // x, y, u, v per vertex, relative to the start of the string
+        std::vector<std::vector<float>> runs;
+        std::vector<Placement> placements;
+        std::vector<Placement> lastPlacements;
+        std::vector<FontRange> ranges;
+        std::vector<float> vertexData;
+        GLuint vbo;
+};
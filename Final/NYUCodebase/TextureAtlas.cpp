@@ -0,0 +1,227 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ATLAS_MAX_DISPLACEMENT 1000000
+
+TextureAtlas::TextureAtlas() {}
+
+bool TextureAtlas::Load(const std::string fileName, float imageWidth, float imageHeight) {
+    std::ifstream infile(fileName.c_str(), std::ios::binary);
+    if(infile.fail()) {
+        std::cout << "Unable to open atlas file " << fileName << "\n";
+        return false;
+    }
+    infile.seekg(0, std::ios::end);
+    std::streamoff length = infile.tellg();
+    infile.seekg(0, std::ios::beg);
+    std::vector<char> data((size_t)length);
+    infile.read(data.data(), length);
+    return Parse(data.data(), data.size(), imageWidth, imageHeight);
+}
+
+static bool matches(const char *text, size_t length, const char *literal) {
+    return length == strlen(literal) && memcmp(text, literal, length) == 0;
+}
+
+const char *TextureAtlas::NextAttribute(const char *cursor, const char *end, const char *&name, size_t &nameLength, const char *&value, size_t &valueLength) const {
+    while(cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n')) {
+        cursor++;
+    }
+    name = cursor;
+    while(cursor < end && *cursor != '=' && *cursor != ' ' && *cursor != '/' && *cursor != '>') {
+        cursor++;
+    }
+    nameLength = cursor - name;
+    if(cursor >= end || *cursor != '=' || nameLength == 0) {
+        return nullptr;
+    }
+    cursor++;
+    if(cursor >= end || (*cursor != '"' && *cursor != '\'')) {
+        return nullptr;
+    }
+    char quote = *cursor++;
+    value = cursor;
+    while(cursor < end && *cursor != quote) {
+        cursor++;
+    }
+    if(cursor >= end) {
+        return nullptr;
+    }
+    valueLength = cursor - value;
+    return cursor + 1;
+}
+
+bool TextureAtlas::Parse(const char *data, size_t length, float imageWidth, float imageHeight) {
+    // one copy of the text; every name below points back into it
+    source.assign(data, data + length);
+    source.push_back('\0');
+    entries.clear();
+    imagePath.clear();
+
+    const char *text = source.data();
+    const char *end = text + length;
+    const char *cursor = text;
+    while((cursor = strchr(cursor, '<')) != nullptr && cursor < end) {
+        const char *tagName = cursor + 1;
+        const char *tagEnd = strchr(tagName, '>');
+        if(tagEnd == nullptr) {
+            break;
+        }
+        const char *attributes = tagName;
+        while(attributes < tagEnd && *attributes != ' ' && *attributes != '\t' && *attributes != '\r' && *attributes != '\n') {
+            attributes++;
+        }
+        bool isSubTexture = matches(tagName, attributes - tagName, "SubTexture");
+        bool isAtlas = matches(tagName, attributes - tagName, "TextureAtlas");
+        if(isSubTexture || isAtlas) {
+            Entry entry;
+            entry.nameOffset = 0;
+            entry.nameLength = 0;
+            float x = 0.0f;
+            float y = 0.0f;
+            float width = 0.0f;
+            float height = 0.0f;
+            const char *name;
+            const char *value;
+            size_t nameLength;
+            size_t valueLength;
+            while((attributes = NextAttribute(attributes, tagEnd, name, nameLength, value, valueLength)) != nullptr) {
+                if(isAtlas) {
+                    if(matches(name, nameLength, "imagePath")) {
+                        imagePath.assign(value, valueLength);
+                    }
+                } else if(matches(name, nameLength, "name")) {
+                    entry.nameOffset = value - text;
+                    entry.nameLength = valueLength;
+                } else if(matches(name, nameLength, "x")) {
+                    x = strtof(value, nullptr);
+                } else if(matches(name, nameLength, "y")) {
+                    y = strtof(value, nullptr);
+                } else if(matches(name, nameLength, "width")) {
+                    width = strtof(value, nullptr);
+                } else if(matches(name, nameLength, "height")) {
+                    height = strtof(value, nullptr);
+                }
+            }
+            if(isSubTexture) {
+                if(entry.nameLength == 0) {
+                    std::cout << "Atlas SubTexture without a name\n";
+                    return false;
+                }
+                entry.region.u = x / imageWidth;
+                entry.region.v = y / imageHeight;
+                entry.region.width = width / imageWidth;
+                entry.region.height = height / imageHeight;
+                entries.push_back(entry);
+            }
+        }
+        cursor = tagEnd + 1;
+    }
+    return BuildHash();
+}
+
+bool TextureAtlas::BuildHash() {
+    unsigned int count = (unsigned int)entries.size();
+    unsigned int bucketCount = std::max(1u, (count + 3) / 4);
+    displacements.assign(bucketCount, 0);
+    slots.assign(std::max(1u, count), -1);
+    if(count == 0) {
+        return true;
+    }
+    const char *text = source.data();
+
+    std::vector<std::vector<int>> buckets(bucketCount);
+    for(unsigned int i = 0; i < count; i++) {
+        buckets[AtlasHash(text + entries[i].nameOffset, entries[i].nameLength, 0) % bucketCount].push_back(i);
+    }
+    std::vector<unsigned int> order(bucketCount);
+    for(unsigned int i = 0; i < bucketCount; i++) {
+        order[i] = i;
+    }
+    // place the crowded buckets first while most slots are still free
+    std::stable_sort(order.begin(), order.end(), [&buckets](unsigned int a, unsigned int b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<unsigned int> placed;
+    for(unsigned int bucket : order) {
+        const std::vector<int> &keys = buckets[bucket];
+        if(keys.empty()) {
+            break;
+        }
+        bool found = false;
+        for(unsigned int displacement = 1; displacement < ATLAS_MAX_DISPLACEMENT && !found; displacement++) {
+            placed.clear();
+            found = true;
+            for(int key : keys) {
+                unsigned int slot = AtlasHash(text + entries[key].nameOffset, entries[key].nameLength, displacement) % count;
+                if(slots[slot] != -1 || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                    found = false;
+                    break;
+                }
+                placed.push_back(slot);
+            }
+            if(found) {
+                for(size_t i = 0; i < keys.size(); i++) {
+                    slots[placed[i]] = keys[i];
+                }
+                displacements[bucket] = displacement;
+            }
+        }
+        if(!found) {
+            std::cout << "Unable to build a perfect hash for the atlas names\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int TextureAtlas::Find(const char *name) const {
+    return Find(name, strlen(name));
+}
+
+int TextureAtlas::Find(const char *name, size_t length) const {
+    if(entries.empty()) {
+        return -1;
+    }
+    unsigned int displacement = displacements[AtlasHash(name, length, 0) % displacements.size()];
+    int index = slots[AtlasHash(name, length, displacement) % slots.size()];
+    if(index < 0 || entries[index].nameLength != length || memcmp(source.data() + entries[index].nameOffset, name, length) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+AtlasRegion TextureAtlas::Get(const char *name) const {
+    int index = Find(name);
+    if(index < 0) {
+        std::cout << "Unknown atlas region " << name << "\n";
+        AtlasRegion empty = {0.0f, 0.0f, 0.0f, 0.0f};
+        return empty;
+    }
+    return entries[index].region;
+}
+
+int TextureAtlas::Count() const {
+    return (int)entries.size();
+}
+
+const AtlasRegion &TextureAtlas::Region(int index) const {
+    return entries[index].region;
+}
+
+std::string TextureAtlas::Name(int index) const {
+    return std::string(source.data() + entries[index].nameOffset, entries[index].nameLength);
+}
+
+const std::vector<unsigned int> &TextureAtlas::Displacements() const {
+    return displacements;
+}
+
+const std::vector<int> &TextureAtlas::Slots() const {
+    return slots;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Normalized rectangle of one sub-texture, in the same units SheetSprite takes.
+struct AtlasRegion {
+    float u;
+    float v;
+    float width;
+    float height;
+};
+
+// FNV-1a with a seed folded into the offset basis. The constexpr form is what
+// the generated header uses to resolve names at compile time; AtlasHash gives
+// the same result for names that are not NUL-terminated.
+constexpr unsigned int AtlasHashStep(const char *name, unsigned int hash) {
+    return *name ? AtlasHashStep(name + 1, (hash ^ (unsigned char)*name) * 16777619u) : hash;
+}
+
+constexpr unsigned int AtlasHash(const char *name, unsigned int seed) {
+    return AtlasHashStep(name, 2166136261u ^ (seed * 0x9E3779B9u));
+}
+
+constexpr bool AtlasNameEquals(const char *a, const char *b) {
+    return *a == *b && (*a == '\0' || AtlasNameEquals(a + 1, b + 1));
+}
+
+inline unsigned int AtlasHash(const char *name, size_t length, unsigned int seed) {
+    unsigned int hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for(size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Reads a TextureAtlas XML (<SubTexture name x y width height/>) into a flat
+// region table. Names are left in the loaded text and referenced by offset, and
+// lookups go through a hash-and-displace perfect hash: one probe into the
+// displacement table, one into the slot table, one name compare.
+class TextureAtlas {
+    public:
+        TextureAtlas();
+
+        bool Load(const std::string fileName, float imageWidth, float imageHeight);
+        bool Parse(const char *data, size_t length, float imageWidth, float imageHeight);
+
+        // Index of the named region in file order, or -1.
+        int Find(const char *name) const;
+        int Find(const char *name, size_t length) const;
+        // Prints a message and returns an empty region for unknown names.
+        AtlasRegion Get(const char *name) const;
+
+        int Count() const;
+        const AtlasRegion &Region(int index) const;
+        std::string Name(int index) const;
+
+        // Perfect hash tables, exposed for the header generator.
+        const std::vector<unsigned int> &Displacements() const;
+        const std::vector<int> &Slots() const;
+
+        std::string imagePath;
+
+    private:
+        struct Entry {
+            size_t nameOffset;
+            size_t nameLength;
+            AtlasRegion region;
+        };
+
+        bool BuildHash();
+        const char *NextAttribute(const char *cursor, const char *end, const char *&name, size_t &nameLength, const char *&value, size_t &valueLength) const;
+
+        std::vector<char> source;
+        std::vector<Entry> entries;
+        std::vector<unsigned int> displacements;
+        std::vector<int> slots;
+};
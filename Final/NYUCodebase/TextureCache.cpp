@@ -0,0 +1,266 @@
+#include "TextureCache.h"
+#include "stb_image.h"
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Written in front of the pixels. Cache files are only ever read back on the
+// machine that wrote them, so native byte order and padding are fine.
+struct TextureCacheHeader {
+    char magic[4];
+    unsigned int version;
+    // hash of the source file, the version and the filtering it was reduced for
+    unsigned long long key;
+    int width;
+    int height;
+    int internalFormat;
+    unsigned int format;
+    unsigned int size;
+    unsigned int padding;
+};
+
+static int channelsOf(GLenum format) {
+    switch(format) {
+        case GL_LUMINANCE:
+            return 1;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        case GL_RGB:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+static bool readFile(const std::string &fileName, std::vector<unsigned char> &contents) {
+    std::ifstream infile(fileName.c_str(), std::ios::binary);
+    if(infile.fail()) {
+        return false;
+    }
+    infile.seekg(0, std::ios::end);
+    contents.resize((size_t)infile.tellg());
+    infile.seekg(0, std::ios::beg);
+    infile.read((char *)contents.data(), contents.size());
+    return !infile.fail();
+}
+
+// 64-bit FNV-1a
+static unsigned long long hashBytes(const unsigned char *bytes, size_t length, unsigned long long seed) {
+    unsigned long long hash = 14695981039346656037ULL ^ seed;
+    for(size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+TextureCache::TextureCache(const std::string &directory) : hits(0), misses(0), directory(directory), saves(0) {}
+
+bool TextureCache::Load(const std::string &fileName, bool nearest, CachedTexture &texture) {
+    std::vector<unsigned char> file;
+    if(!readFile(fileName, file)) {
+        std::cout << "Unable to load image " << fileName << ". Make sure the path is correct\n";
+        return false;
+    }
+    unsigned long long key = 0;
+    std::string path;
+    if(!directory.empty()) {
+        // reading and hashing the PNG is far cheaper than inflating it
+        key = hashBytes(file.data(), file.size(), TEXTURE_CACHE_VERSION * 2 + (nearest ? 1 : 0));
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.tex", key);
+        path = directory + name;
+        if(Map(path, key, texture)) {
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    int width, height, components;
+    unsigned char *rgba = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &components, STBI_rgb_alpha);
+    if(rgba == NULL) {
+        std::cout << "Unable to load image " << fileName << ": " << stbi_failure_reason() << "\n";
+        return false;
+    }
+    Reduce(rgba, width, height, nearest, texture);
+    stbi_image_free(rgba);
+    if(!path.empty()) {
+        Save(path, key, texture);
+    }
+    return true;
+}
+
+void TextureCache::Reduce(const unsigned char *rgba, int width, int height, bool nearest, CachedTexture &texture) {
+    int count = width * height;
+    bool opaque = true;
+    bool gray = true;
+    // every texel either fully transparent or opaque white
+    bool whiteMask = true;
+    for(int i = 0; i < count && (opaque || gray || whiteMask); i++) {
+        const unsigned char *texel = rgba + i * 4;
+        if(texel[3] != 255) {
+            opaque = false;
+        }
+        if(texel[0] != texel[1] || texel[1] != texel[2]) {
+            gray = false;
+        }
+        if(texel[3] != 0 && (texel[3] != 255 || texel[0] != 255 || texel[1] != 255 || texel[2] != 255)) {
+            whiteMask = false;
+        }
+    }
+    texture.width = width;
+    texture.height = height;
+    // which of each texel's four bytes are kept, in order
+    int keep[4] = {0, 1, 2, 3};
+    int channels = 4;
+    if(opaque && gray) {
+        texture.internalFormat = GL_LUMINANCE;
+        texture.format = GL_LUMINANCE;
+        channels = 1;
+    } else if(opaque) {
+        texture.internalFormat = GL_RGB;
+        texture.format = GL_RGB;
+        channels = 3;
+    } else if(whiteMask && nearest) {
+        // Samples as (a, a, a, a). Transparent texels turn black, which only
+        // looks the same when filtering never blends them with their neighbours.
+        texture.internalFormat = GL_INTENSITY;
+        texture.format = GL_LUMINANCE;
+        keep[0] = 3;
+        channels = 1;
+    } else if(gray) {
+        texture.internalFormat = GL_LUMINANCE_ALPHA;
+        texture.format = GL_LUMINANCE_ALPHA;
+        keep[1] = 3;
+        channels = 2;
+    } else {
+        texture.internalFormat = GL_RGBA;
+        texture.format = GL_RGBA;
+    }
+    texture.data.resize(count * channels);
+    unsigned char *out = texture.data.data();
+    if(channels == 4) {
+        memcpy(out, rgba, count * 4);
+    } else if(channels == 1) {
+        const unsigned char *in = rgba + keep[0];
+        for(int i = 0; i < count; i++) {
+            out[i] = in[i * 4];
+        }
+    } else {
+        for(int i = 0; i < count; i++) {
+            for(int c = 0; c < channels; c++) {
+                out[i * channels + c] = rgba[i * 4 + keep[c]];
+            }
+        }
+    }
+    texture.pixels = texture.data.data();
+}
+
+bool TextureCache::Map(const std::string &path, unsigned long long key, CachedTexture &texture) {
+#ifdef _WINDOWS
+    std::vector<unsigned char> file;
+    if(!readFile(path, file) || file.size() < sizeof(TextureCacheHeader)) {
+        return false;
+    }
+    const unsigned char *bytes = file.data();
+    size_t size = file.size();
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if(descriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    if(fstat(descriptor, &info) != 0 || (size_t)info.st_size < sizeof(TextureCacheHeader)) {
+        close(descriptor);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED) {
+        return false;
+    }
+    const unsigned char *bytes = (const unsigned char *)mapping;
+#endif
+    const TextureCacheHeader *header = (const TextureCacheHeader *)bytes;
+    bool valid = memcmp(header->magic, "TXCH", 4) == 0 && header->version == TEXTURE_CACHE_VERSION && header->key == key &&
+        header->size == (unsigned int)(header->width * header->height * channelsOf(header->format)) &&
+        sizeof(TextureCacheHeader) + header->size == size;
+    if(!valid) {
+#ifndef _WINDOWS
+        munmap(mapping, size);
+#endif
+        return false;
+    }
+    texture.width = header->width;
+    texture.height = header->height;
+    texture.internalFormat = header->internalFormat;
+    texture.format = header->format;
+#ifdef _WINDOWS
+    texture.data.swap(file);
+    texture.pixels = texture.data.data() + sizeof(TextureCacheHeader);
+#else
+    texture.mapping = mapping;
+    texture.mappingSize = size;
+    texture.pixels = bytes + sizeof(TextureCacheHeader);
+#endif
+    return true;
+}
+
+void TextureCache::Save(const std::string &path, unsigned long long key, const CachedTexture &texture) {
+    TextureCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "TXCH", 4);
+    header.version = TEXTURE_CACHE_VERSION;
+    header.key = key;
+    header.width = texture.width;
+    header.height = texture.height;
+    header.internalFormat = texture.internalFormat;
+    header.format = texture.format;
+    header.size = (unsigned int)(texture.width * texture.height * channelsOf(texture.format));
+
+    // written under a name of its own and renamed into place, so a reader
+    // never maps a half-written file and two writers never interleave
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%d.tmp", saves++);
+    std::string temporary = path + suffix;
+    {
+        std::ofstream outfile(temporary.c_str(), std::ios::binary);
+        outfile.write((const char *)&header, sizeof(header));
+        outfile.write((const char *)texture.pixels, header.size);
+        if(outfile.fail()) {
+            std::cout << "Unable to write texture cache " << temporary << "\n";
+            outfile.close();
+            remove(temporary.c_str());
+            return;
+        }
+    }
+    if(rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+    }
+}
+
+void TextureCache::Release(CachedTexture &texture) {
+#ifndef _WINDOWS
+    if(texture.mapping) {
+        munmap(texture.mapping, texture.mappingSize);
+        texture.mapping = NULL;
+    }
+#endif
+    std::vector<unsigned char>().swap(texture.data);
+    texture.pixels = NULL;
+}
+
+void TextureCache::Upload(const CachedTexture &texture) {
+    // reduced formats have rows that are not multiples of four bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, texture.internalFormat, texture.width, texture.height, 0, texture.format, GL_UNSIGNED_BYTE, texture.pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
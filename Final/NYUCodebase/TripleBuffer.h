@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+
+// Hands the most recent value from one producer thread to one consumer thread
+// without either side waiting. The producer fills Back() and calls Publish();
+// the consumer calls Acquire() and reads Front(). Each of the three slots is
+// owned by exactly one side at a time, and ownership only changes through the
+// atomic exchange, so a slot's contents (including anything the consumer
+// caches in it) are never touched by both threads at once.
+template <typename T>
+class TripleBuffer {
+    public:
+        TripleBuffer() : back(0), middle(1), front(2) {}
+
+        T &Back() { return slots[back]; }
+        // Swaps the filled back slot into the middle; whatever was there becomes the new back.
+        void Publish() {
+            back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        // Takes the newest published slot if there is one. Returns false and keeps
+        // the current front when nothing was published since the last call.
+        bool Acquire() {
+            if(!(middle.load(std::memory_order_relaxed) & FRESH)) {
+                return false;
+            }
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+            return true;
+        }
+        T &Front() { return slots[front]; }
+
+    private:
+        TripleBuffer(const TripleBuffer &);
+        TripleBuffer &operator=(const TripleBuffer &);
+
+        enum { INDEX = 3, FRESH = 4 };
+
+        T slots[3];
+        int back;
+        std::atomic<int> middle;
+        int front;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdlib.h>
+
+inline float lerp(float v0, float v1, float t)
+{
+    return (1.0f-t)*v0 + t*v1;
+}
+
+inline float genRandom(float low, float high)
+{
+    return low + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/(high-low)));
+}
+
+// Small seeded generator (xorshift32) for anything the simulation draws, so a
+// run can be reproduced from its seed. rand() stays for cosmetic effects.
+class Random
+{
+public:
+    Random() : state(0x9E3779B9u) {}
+    explicit Random(unsigned int seed) { Seed(seed); }
+    void Seed(unsigned int seed)
+    {
+        state = seed ? seed : 0x9E3779B9u;
+    }
+    unsigned int Next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float Range(float low, float high)
+    {
+        return low + (high - low) * ((Next() >> 8) * (1.0f / 16777216.0f));
+    }
+    unsigned int state;
+};
@@ -0,0 +1,148 @@
+#include "VoiceManager.h"
+
+VoiceManager::VoiceManager() : clock(0) {
+    stats.played = 0;
+    stats.merged = 0;
+    stats.capped = 0;
+    stats.stolen = 0;
+    stats.dropped = 0;
+}
+
+void VoiceManager::Open(int voiceCount) {
+    Voice free;
+    free.sound = -1;
+    free.started = 0;
+    free.position = 0;
+    voices.assign(voiceCount, free);
+}
+
+int VoiceManager::Register(Mix_Chunk *chunk, int maxVoices, int priority) {
+    Sound sound;
+    sound.chunk = chunk;
+    sound.maxVoices = maxVoices > 0 ? maxVoices : 1;
+    sound.priority = priority;
+    sound.volume = 256;
+    sound.playedThisFrame = false;
+    sounds.push_back(sound);
+    return (int)sounds.size() - 1;
+}
+
+bool VoiceManager::Busy(int voice) const {
+    return voices[voice].sound >= 0 && voices[voice].position < sounds[voices[voice].sound].chunk->alen / sizeof(Sint16);
+}
+
+int VoiceManager::Steal(int priority) const {
+    int victim = -1;
+    for(int voice = 0; voice < (int)voices.size(); voice++) {
+        int victimPriority = sounds[voices[voice].sound].priority;
+        if(victimPriority > priority) {
+            continue;
+        }
+        if(victim < 0) {
+            victim = voice;
+            continue;
+        }
+        int bestPriority = sounds[voices[victim].sound].priority;
+        if(victimPriority < bestPriority || (victimPriority == bestPriority && voices[voice].started < voices[victim].started)) {
+            victim = voice;
+        }
+    }
+    return victim;
+}
+
+int VoiceManager::Play(int sound) {
+    Sound &request = sounds[sound];
+    if(!request.chunk) {
+        return -1;
+    }
+    if(request.playedThisFrame) {
+        stats.merged++;
+        return -1;
+    }
+
+    int playing = 0;
+    int oldest = -1;
+    int freeVoice = -1;
+    for(int voice = 0; voice < (int)voices.size(); voice++) {
+        if(!Busy(voice)) {
+            if(freeVoice < 0) {
+                freeVoice = voice;
+            }
+            continue;
+        }
+        if(voices[voice].sound == sound) {
+            playing++;
+            if(oldest < 0 || voices[voice].started < voices[oldest].started) {
+                oldest = voice;
+            }
+        }
+    }
+
+    int voice = freeVoice;
+    if(playing >= request.maxVoices) {
+        voice = oldest;
+        stats.capped++;
+    } else if(voice < 0) {
+        // every voice is busy here, so Steal only has to weigh priorities
+        voice = Steal(request.priority);
+        if(voice < 0) {
+            stats.dropped++;
+            return -1;
+        }
+        stats.stolen++;
+    }
+    voices[voice].sound = sound;
+    voices[voice].started = clock++;
+    voices[voice].position = 0;
+    request.playedThisFrame = true;
+    stats.played++;
+    return voice;
+}
+
+void VoiceManager::Stop(int sound) {
+    for(Voice &voice : voices) {
+        if(voice.sound == sound) {
+            voice.sound = -1;
+        }
+    }
+}
+
+void VoiceManager::SetVolume(int sound, float volume) {
+    volume = volume < 0.0f ? 0.0f : (volume > 1.0f ? 1.0f : volume);
+    sounds[sound].volume = (int)(volume * 256.0f + 0.5f);
+}
+
+void VoiceManager::EndFrame() {
+    for(Sound &sound : sounds) {
+        sound.playedThisFrame = false;
+    }
+}
+
+void VoiceManager::Mix(int *mix, int frames, int channels) {
+    unsigned int wanted = (unsigned int)(frames * channels);
+    for(int index = 0; index < (int)voices.size(); index++) {
+        if(!Busy(index)) {
+            continue;
+        }
+        Voice &voice = voices[index];
+        const Sound &sound = sounds[voice.sound];
+        const Sint16 *samples = (const Sint16 *)sound.chunk->abuf;
+        unsigned int length = sound.chunk->alen / sizeof(Sint16);
+        unsigned int count = length - voice.position < wanted ? length - voice.position : wanted;
+        samples += voice.position;
+        for(unsigned int i = 0; i < count; i++) {
+            mix[i] += (samples[i] * sound.volume) >> 8;
+        }
+        voice.position += count;
+    }
+}
+
+int VoiceManager::BusyCount() const {
+    int busy = 0;
+    for(int voice = 0; voice < (int)voices.size(); voice++) {
+        if(Busy(voice)) {
+            busy++;
+        }
+    }
+    return busy;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <SDL_mixer.h>
+
+struct VoiceStats {
+    unsigned int played;
+    // requests folded into one already started the same frame
+    unsigned int merged;
+    // requests that restarted the oldest copy of a sound already at its cap
+    unsigned int capped;
+    // voices cut off for a sound of equal or higher priority
+    unsigned int stolen;
+    // requests with every voice busy on something more important
+    unsigned int dropped;
+};
+
+// Plays sound effects on a fixed set of voices and mixes them. Each registered
+// sound has a cap on copies playing at once and a priority; when every voice
+// is busy a new sound takes over the oldest voice of the lowest priority not
+// above its own, or is dropped. A sound asked for twice in one frame only
+// starts once. Chunks must be in the output format: signed 16-bit, interleaved
+// channels, as Mix_LoadWAV converts them once audio is open.
+//
+// Not thread safe; AudioMixer keeps it on the mixer thread.
+class VoiceManager {
+    public:
+        VoiceManager();
+
+        void Open(int voiceCount);
+        // Returns the id to pass to Play. Register everything before sounds start playing.
+        int Register(Mix_Chunk *chunk, int maxVoices, int priority);
+        // Returns the voice the sound started on, or -1 if it was merged or dropped.
+        int Play(int sound);
+        // Silences every voice playing the sound.
+        void Stop(int sound);
+        // 0 is silent, 1 is the sample's own level.
+        void SetVolume(int sound, float volume);
+        // Closes the deduplication window; call once per simulation step.
+        void EndFrame();
+        // Adds frames of every playing voice into mix, channels samples per frame.
+        void Mix(int *mix, int frames, int channels);
+
+        int BusyCount() const;
+        VoiceStats stats;
+
+    private:
+        struct Sound {
+            Mix_Chunk *chunk;
+            int maxVoices;
+            int priority;
+            // fixed point, 256 is full level
+            int volume;
+            bool playedThisFrame;
+        };
+        struct Voice {
+            // -1 when the voice was never used
+            int sound;
+            // Play() call count when it started, so lower is older
+            unsigned int started;
+            // next sample to mix from the chunk
+            unsigned int position;
+        };
+
+        bool Busy(int voice) const;
+        int Steal(int priority) const;
+
+        std::vector<Sound> sounds;
+        std::vector<Voice> voices;
+        unsigned int clock;
+};
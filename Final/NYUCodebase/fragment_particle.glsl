@@ -0,0 +1,6 @@
+
+varying vec4 colorVar;
+
+void main() {
+	gl_FragColor = colorVar;
+}
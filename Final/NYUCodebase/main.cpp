@@ -15,9 +15,32 @@
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
-#include "SatCollision.h"
+#include "Simulation.h"
+#include "Replay.h"
+#include "ParticleEmitter.h"
+#include "SpriteBatch.h"
+#include "TextCache.h"
+#include "FrameScheduler.h"
+#include "TripleBuffer.h"
+#include "RenderSnapshot.h"
+#include "JobSystem.h"
+#include "SoundBank.h"
+#include "AudioMixer.h"
+#include "MusicStream.h"
+#include "AssetManager.h"
+#ifdef DEBUG
+#include "TextureAtlas.h"
+#else
+#include "SheetAtlas.h"
+#endif
+#include "Utilities.h"
 #include <utility>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #ifdef _WINDOWS
 #define RESOURCE_FOLDER ""
 #else
@@ -26,120 +49,28 @@
 
 SDL_Window* displayWindow;
 
-GLuint LoadTexture(const char *filePath, int near);
-void DrawText(ShaderProgram &program, int fontTexture, std::string text, float size, float spacing, glm::vec3 position);
-const std::vector<std::pair<float, float>> floatPairs(std::vector<glm::vec4> vertices);
+// Debug builds read sheet.xml at startup so edits show up without regenerating
+// SheetAtlas.h; release builds look names up at compile time.
+#ifdef DEBUG
+TextureAtlas sheetAtlas;
+#define SHEET_REGION(name) sheetAtlas.Get(name)
+#else
+#define SHEET_REGION(name) SheetAtlas::regions[std::integral_constant<int, SheetAtlas::find(name)>::value]
+#endif
 
 enum GameState { START_SCREEN, INSTRUCTION_SCREEN, MAIN_GAME_SCREEN, END_GAME_SCREEN};
-enum EntityType { PLAYER, BULLET, ASTEROID };
 
+// Owned by the simulation thread once it starts; the main thread sees it through
+// RenderSnapshot::mode and changes it with Play::setMode().
 GameState gameMode = START_SCREEN;
 
-float lerp(float v0, float v1, float t)
-{
-    return (1.0f-t)*v0 + t*v1;
-}
-
-float genRandom(float low, float high)
-{
-    return low + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/(high-low)));
-}
-
-class Particle
-{
-public:
-    Particle(glm::vec3 position, glm::vec3 velocity, float lifetime, glm::vec4 sColor, glm::vec4 eColor)
-    : position(position), velocity(velocity), lifetime(lifetime), startColor(sColor), endColor(eColor)
-    {
-        position.x += velocity.x * lifetime * 2;
-        position.y += velocity.y * lifetime * 2;
-    }
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 velocityDeviation;
-    float lifetime;
-    
-    glm::vec4 startColor;
-    glm::vec4 endColor;
-};
-
-class ParticleEmitter
-{
-public:
-    ParticleEmitter() {}
-    ParticleEmitter(glm::vec3 position, float particleLife, unsigned int particleAmount) : position(position), maxLifetime(particleLife)
-    {
-        for(int add = 0; add < particleAmount; add++)
-        {
-            particles.push_back(Particle(glm::vec3(position), glm::vec3(genRandom(-1, 1), genRandom(-1, 1), 0.0f), genRandom(0, maxLifetime), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)));
-        }
-        enable = true;
-    }
-    ParticleEmitter(glm::vec3 position, float emitterLife, float particleLife, unsigned int particleAmount, glm::vec4 startColor, glm::vec4 endColor) : position(position), emitterLife(emitterLife), maxLifetime(particleLife)
-    {
-        for(int add = 0; add < particleAmount; add++)
-        {
-            particles.push_back(Particle(glm::vec3(position), glm::vec3(genRandom(-1, 1), genRandom(-1, 1), 0.0f), genRandom(0, maxLifetime), startColor, endColor));
-        }
-        timer = 0.0f;
-        enable = true;
-    }
-    void Update(float elapsed)
-    {
-        timer += elapsed;
-        if(timer > emitterLife && emitterLife != -1.0f)
-        {
-            enable = false;
-        }
-        matrix = glm::mat4(1.0f);
-        for(Particle& part : particles)
-        {
-            if(part.lifetime > maxLifetime)
-            {
-                part.lifetime = 0.0f;
-                part.position.x = position.x;
-                part.position.y = position.y;
-            }
-            part.position.x += part.velocity.x * elapsed;
-            part.position.y += part.velocity.y * elapsed;
-            part.lifetime += elapsed;
-        }
-    }
-    void Render(ShaderProgram& program)
-    {
-        program.SetModelMatrix(matrix);
-        std::vector<float> vertices;
-        for(int i=0; i < particles.size(); i++) {
-            vertices.push_back(particles[i].position.x);
-            vertices.push_back(particles[i].position.y);
-        }
-        std::vector<float> particleColors;
-        for(int i=0; i < particles.size(); i++) {
-            float relativeLifetime = (particles[i].lifetime/maxLifetime);
-            particleColors.push_back(lerp(particles[i].startColor.r, particles[i].endColor.r, relativeLifetime));
-            particleColors.push_back(lerp(particles[i].startColor.g, particles[i].endColor.g, relativeLifetime));
-            particleColors.push_back(lerp(particles[i].startColor.b, particles[i].endColor.b, relativeLifetime));
-            particleColors.push_back(lerp(particles[i].startColor.a, particles[i].endColor.a, relativeLifetime));
-        }
-        GLuint colorAttribute = glGetAttribLocation(program.programID, "color");
-        glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices.data());
-        glEnableVertexAttribArray(program.positionAttribute);
-        glVertexAttribPointer(colorAttribute, 4, GL_FLOAT, false, 0, particleColors.data());
-        glEnableVertexAttribArray(colorAttribute);
-        glDrawArrays(GL_POINTS, 0, particles.size());
-    }
-    
-    bool enable;
-    glm::vec3 position;
-    glm::mat4 matrix;
-    float maxLifetime;
-    float emitterLife;
-    float timer;
-    std::pair<float, float> maxSpan;
-    
-    std::vector<Particle> particles;
-    
-};
+// 60 FPS (1.0f/60.0f) (update sixty times a second)
+#define FIXED_TIMESTEP 0.0166666f
+#define MAX_TIMESTEPS 6
+// sound effects that can play at once; music plays through SDL_mixer on its own
+#define SOUND_VOICES 16
+// seconds of GL uploads the loading screen allows itself each frame
+#define ASSET_UPLOAD_BUDGET 0.004f
 
 class SheetSprite {
 public:
@@ -156,6 +87,8 @@ public:
             -0.5f * size * aspect, -0.5f * size,
             0.5f * size * aspect, -0.5f * size};
     }
+    SheetSprite(unsigned int textureID, AtlasRegion region, float size)
+    : SheetSprite(textureID, region.u, region.v, region.width, region.height, size) {}
     void DrawSprite(ShaderProgram &program)
     {
         glBindTexture(GL_TEXTURE_2D, textureID);
@@ -175,6 +108,18 @@ public:
         glDisableVertexAttribArray(program.positionAttribute);
         glDisableVertexAttribArray(program.texCoordAttribute);
     }
+    void DrawSprite(SpriteBatch &batch, const glm::mat4 &matrix)
+    {
+        GLfloat texCoords[] = {
+            u, v+height,
+            u+width, v,
+            u, v,
+            u+width, v,
+            u, v+height,
+            u+width, v+height
+        };
+        batch.Draw(textureID, matrix, vertices.data(), texCoords);
+    }
     std::vector<float> vertices;
     float aspect;
     float size;
@@ -185,609 +130,359 @@ public:
     float height;
 };
 
-class Entity{
+void DrawAsteroid(ShaderProgram& program, const RenderSnapshot& frame, const AsteroidSnapshot& asteroid, float alpha)
+{
+    program.SetModelMatrix(asteroid.transform.Matrix(alpha));
+    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, frame.outlines.data() + asteroid.firstPoint*2);
+    glEnableVertexAttribArray(program.positionAttribute);
+    glDrawArrays(GL_LINE_LOOP, 0, asteroid.pointCount);
+    glDisableVertexAttribArray(program.positionAttribute);
+}
+
+// Progress bar across the middle of the screen, drawn while assets load.
+void DrawLoadingBar(ShaderProgram& program, float fraction)
+{
+    float right = -1.0f + 2.0f * fraction;
+    float vertices[] = {-1.0f, -0.02f, right, -0.02f, right, 0.02f, -1.0f, -0.02f, right, 0.02f, -1.0f, 0.02f};
+    glUseProgram(program.programID);
+    program.SetModelMatrix(glm::mat4(1.0f));
+    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
+    glEnableVertexAttribArray(program.positionAttribute);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDisableVertexAttribArray(program.positionAttribute);
+}
+
+// Something the main thread asks of the simulation thread, applied before its next step.
+struct GameRequest
+{
+    enum Kind { COMMAND, MODE } kind;
+    SimulationCommand command;
+    GameState mode;
+};
+
+class Play
+{
 public:
-    Entity(){}
-    Entity(glm::vec3 position, glm::vec3 size, float rotation, glm::vec3 friction, EntityType type) : position(position), size(size), rotation(rotation), friction(friction), type(type)
+    // the sounds are already decoded into soundBank by the asset workers, so acquiring them here is a lookup
+    Play(unsigned int texture, unsigned int seed, int workers, SoundBank& soundBank) : seed(seed), timestep(FIXED_TIMESTEP), heldKeys(0), pendingShots(0), running(false), jobs(workers), soundBank(soundBank), audio(SOUND_VOICES)
     {
-        matrix = glm::mat4(1.0f);
-        matrix = glm::scale(matrix, size);
-        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-        matrix = glm::translate(matrix, position);
-        glm::vec3 defaultSet = glm::vec3(0.0f, 0.0f, 0.0f);
-        velocity = defaultSet;
-        acceleration = defaultSet;
-        playerTag = -1;
-    }
-    Entity(glm::vec3 position, glm::vec3 size, float rotation, glm::vec3 friction, std::vector<SDL_Scancode> keys, EntityType type) : position(position), size(size), rotation(rotation), friction(friction), type(type)
+        background = ParticleEmitter(glm::vec3(0.0f, 0.0f, 0.0f), -1, 5, 1000, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+        screenShake = false;
+        screenTime = 0.0f;
+        collisions = EmitterPool(32, 1.0f, 1.0f, 50, glm::vec4(1.0f, 0.5f, 0.0f, 1.0f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        player1Sprite = SheetSprite(texture, SHEET_REGION("playerShip2_red.png"), 0.1f);
+        player2Sprite = SheetSprite(texture, SHEET_REGION("playerShip2_blue.png"), 0.1f);
+        bulletSprite = SheetSprite(texture, SHEET_REGION("laserRed03.png"), 0.1f);
+        sim = Simulation(extents(player1Sprite), extents(player2Sprite), extents(bulletSprite), seed);
+        sim.jobs = &jobs;
+        sCodes[0] = {SDL_SCANCODE_W, SDL_SCANCODE_S, SDL_SCANCODE_A, SDL_SCANCODE_D, SDL_SCANCODE_F}; // up, down, rotateL, rotateR, Shoot
+        sCodes[1] = {SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT, SDL_SCANCODE_SPACE};
+        // both players share the shot and hit samples; deaths outrank hits outrank shots
+        shootSound = registerSound(RESOURCE_FOLDER"shoot2.wav", 4, 0);
+        hitSound = registerSound(RESOURCE_FOLDER"hit.wav", 2, 1);
+        deathSound[0] = registerSound(RESOURCE_FOLDER"death.wav", 1, 2);
+        deathSound[1] = registerSound(RESOURCE_FOLDER"death2.wav", 1, 2);
+        audio.Open();
+    }
+    // the mixer thread must be gone before the chunks it reads are released
+    ~Play()
+    {
+        audio.Close();
+        for(Mix_Chunk* chunk : sounds)
+        {
+            soundBank.Release(chunk);
+        }
+    }
+    Simulation sim;
+    unsigned int seed;
+    // length of one simulation step; recorded so replays use the same one
+    float timestep;
+    // Written by the main thread, read by the simulation thread: movement keys
+    // held right now, and shots pressed since the last step, both as InputBits.
+    std::atomic<unsigned int> heldKeys;
+    std::atomic<unsigned int> pendingShots;
+    std::mutex requestLock;
+    std::vector<GameRequest> requests;
+    // simulation thread only; swapped with requests so the lock is held briefly
+    std::vector<GameRequest> applying;
+    // filled by the simulation thread, drawn by the main thread
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::atomic<bool> running;
+    std::thread thread;
+    // helps the simulation thread with collision and particle updates
+    JobSystem jobs;
+    ReplayRecorder recorder;
+    std::string recordPath;
+    SheetSprite player1Sprite;
+    SheetSprite player2Sprite;
+    SheetSprite bulletSprite;
+    std::vector<SDL_Scancode> sCodes[2];
+    // one reference for each registered sound, given back when the game ends
+    SoundBank& soundBank;
+    std::vector<Mix_Chunk*> sounds;
+    // the simulation thread only queues commands; mixing happens on the mixer's own thread
+    AudioMixer audio;
+    int shootSound;
+    int hitSound;
+    int deathSound[2];
+    // simulation thread state; the renderer gets copies through snapshots
+    bool screenShake;
+    float screenTime;
+    ParticleEmitter background;
+    EmitterPool collisions;
+    // main thread only
+    SpriteBatch sprites;
+    int registerSound(const char* path, int maxVoices, int priority)
     {
-        matrix = glm::mat4(1.0f);
-        matrix = glm::translate(matrix, position);
-        matrix = glm::scale(matrix, size);
-        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-        matrix = glm::mat4(1.0f);
-        for(SDL_Scancode add : keys)
+        Mix_Chunk* chunk = soundBank.Acquire(path);
+        if(chunk)
         {
-            sCodes.push_back(add);
+            sounds.push_back(chunk);
         }
-        moveSpeed = 0.75f;
-        rotationSpeed = moveSpeed*5;
-        glm::vec3 defaultSet = glm::vec3(0.0f, 0.0f, 0.0f);
-        velocity = defaultSet;
-        acceleration = defaultSet;
-        time = 0.0f;
-        health = 5;
-        rotateAmount = 0.0f;
-        playerTag = 1;
-    }
-    void setEdgeSet()
-    {
-        edgeSet.push_back(glm::vec4(sprite.vertices[0], sprite.vertices[1], 1.0f, 1.0f));
-        edgeSet.push_back(glm::vec4(sprite.vertices[10], sprite.vertices[11], 1.0f, 1.0f));
-        edgeSet.push_back(glm::vec4(sprite.vertices[2], sprite.vertices[3], 1.0f, 1.0f));
-        edgeSet.push_back(glm::vec4(sprite.vertices[4], sprite.vertices[5], 1.0f, 1.0f));
+        return audio.Register(chunk, maxVoices, priority);
     }
-    std::vector<glm::vec4> transformEdgeSet()
+    SpriteExtents extents(const SheetSprite& sprite)
     {
-        std::vector<glm::vec4> temp;
-        for(glm::vec4& transform : edgeSet)
-        {
-            temp.push_back(matrix * transform);
-        }
-        return temp;
+        return SpriteExtents(0.5f * sprite.size * sprite.aspect, 0.5f * sprite.size);
     }
-    void Update(float elapsed)
+    // Runs on the main thread and only reads the snapshot and the sprites, which
+    // never change after construction. alpha is how far the clock is between the
+    // snapshot's last two steps; everything is drawn blended between them.
+    void Render(RenderSnapshot& frame, ShaderProgram& program, ShaderProgram& untextProgram, ParticleProgram& particleProgram, glm::mat4 viewMatrix, float alpha)
     {
-        matrix = glm::mat4(1.0f);
-        velocity.x = lerp(velocity.x, 0.0f, friction.x * elapsed);
-        velocity.y = lerp(velocity.y, 0.0f, friction.y * elapsed);
-        velocity.x += acceleration.x * elapsed;
-        velocity.y += acceleration.y * elapsed;
-        position.x += velocity.x * elapsed;
-        position.y += velocity.y * elapsed;
-        position.z = 0.0f;
-        if(type == PLAYER)
-        {
-            time += elapsed;
-            if(time >= 1.0f)
-            {
-                shoot = true;
-                time = 0.0f;
-            }
-            if(position.x < -1.8f)
-            {
-                position.x = 1.75f;
-            }
-            if(position.x > 1.8f)
-            {
-                position.x = -1.75f;
-            }
-            if(position.y < -1.01f)
-            {
-                position.y = 0.9f;
-            }
-            if(position.y > 1.01f)
-            {
-                position.y = -0.9f;
-            }
-        }
-        if(type == BULLET)
+        viewMatrix = glm::mat4(1.0f);
+        if(frame.screenShake)
         {
-            if(position.x < -1.85f || position.x > 1.85f || position.y < -1.1f || position.y > 1.1f)
-            {
-                velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-                position = glm::vec3(0.0f, -20.0f, 0.0f);
-            }
+            viewMatrix = glm::translate(viewMatrix, frame.shakeOffset);
         }
-        rotateAmount = rotateAmount * (3.1415926585 / 180.0f);
-        rotation += rotateAmount;
-        matrix = glm::translate(matrix, position);
-        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-    }
-    void Process(const Uint8* keys)
-    {
-        if(keys[sCodes[0]]) // move up
+        program.SetViewMatrix(viewMatrix);
+        untextProgram.SetViewMatrix(viewMatrix);
+        particleProgram.program.SetViewMatrix(viewMatrix);
+        if(frame.background.gpuEvaluated)
         {
-            velocity = glm::vec3(cos(rotation+glm::pi<float>()/2)*moveSpeed, sin(rotation+glm::pi<float>()/2)*moveSpeed, 0.0f);
+            frame.background.RenderGPU(particleProgram, alpha);
         }
-        if(keys[sCodes[1]]) // move down
+        glUseProgram(untextProgram.programID);
+        if(!frame.background.gpuEvaluated)
         {
-            velocity = glm::vec3(cos(rotation+glm::pi<float>()/2)*-moveSpeed, sin(rotation+glm::pi<float>()/2)*-moveSpeed, 0.0f);
+            frame.background.Render(untextProgram, alpha);
         }
-        if(keys[sCodes[2]]) // rotate left
+        frame.collisions.Render(program, alpha);
+        for(const AsteroidSnapshot& asteroid : frame.asteroids)
         {
-            rotateAmount += rotationSpeed;
+            DrawAsteroid(untextProgram, frame, asteroid, alpha);
         }
-        if(keys[sCodes[3]]) // rotate right
+        sprites.Begin();
+        player1Sprite.DrawSprite(sprites, frame.player1.Matrix(alpha));
+        if(frame.p2Enable)
         {
-            rotateAmount -= rotationSpeed;
+            player2Sprite.DrawSprite(sprites, frame.player2.Matrix(alpha));
         }
-        if(rotation > 360)
+        for(const SnapshotTransform& bullet : frame.bullets)
         {
-            rotation = 0;
+            bulletSprite.DrawSprite(sprites, bullet.Matrix(alpha));
         }
+        sprites.End(program);
     }
-    void Render(ShaderProgram& program)
+    void Start()
     {
-        program.SetModelMatrix(matrix);
-        sprite.DrawSprite(program);
+        running = true;
+        thread = std::thread(&Play::simulationLoop, this);
     }
-    void collisionUpdate()
+    void Stop()
     {
-        if(type == PLAYER)
+        running = false;
+        if(thread.joinable())
         {
-            health--;
-            Mix_PlayChannel(-1, hitSound, 0);
-        }
-        if(type == BULLET)
-        {
-            position = glm::vec3(0.0f, -20.0f, 0.0f);
-            velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+            thread.join();
         }
     }
-    glm::mat4 matrix;
-    glm::vec3 position;
-    glm::vec3 size;
-    float rotation;
-    float rotateAmount;
-    float moveSpeed;
-    float rotationSpeed;
-    
-    glm::vec3 velocity;
-    glm::vec3 acceleration;
-    glm::vec3 friction;
-    
-    std::vector<glm::vec4> edgeSet;
-    
-    int health;
-    float time;
-    bool shoot;
-    
-    std::vector<SDL_Scancode> sCodes;
-    
-    EntityType type;
-    int playerTag;
-    
-    SheetSprite sprite;
-    
-    Mix_Chunk* shootSound;
-    Mix_Chunk* hitSound;
-    Mix_Chunk* deathSound;
-    
-private:
-};
-
-class Asteroid : public std::iterator<std::input_iterator_tag, Asteroid>
-{
-public:
-    Asteroid(glm::vec3 position, glm::vec3 size, float rotation, glm::vec3 velocity, std::vector<float> indices) : position(position), size(size), rotation(rotation), velocity(velocity)
+    void startRecording(const std::string& path)
     {
-        matrix = glm::mat4(1.0f);
-        matrix = glm::scale(matrix, size);
-        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
-        matrix = glm::translate(matrix, position);
-        for(float addIndex : indices)
-        {
-            index.push_back(addIndex);
-        }
-        for(int mod = 0; mod < index.size(); mod+=2)
-        {
-            index[mod] *= size.x;
-            index[mod+1] *= size.y;
-        }
-        isEnable = true;
-        setEdgeSet();
+        ReplayHeader header;
+        header.seed = seed;
+        header.timestep = timestep;
+        header.hashInterval = REPLAY_HASH_INTERVAL;
+        header.player1 = extents(player1Sprite);
+        header.player2 = extents(player2Sprite);
+        header.bullet = extents(bulletSprite);
+        recorder.Begin(header);
+        recordPath = path;
     }
-    void Render(ShaderProgram& program)
+    void finishRecording()
     {
-        program.SetModelMatrix(matrix);
-        glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, index.data());
-        glEnableVertexAttribArray(program.positionAttribute);
-        glDrawArrays(GL_LINE_LOOP, 0, (int)index.size()/2);
-        glDisableVertexAttribArray(program.positionAttribute);
-    }
-    void Update(float elapsed)
-    {
-        matrix = glm::mat4(1.0f);
-        position.x += velocity.x * elapsed;
-        position.y += velocity.y * elapsed;
-        if(position.x < -1.8f)
-        {
-            position.x = 1.75f;
-        }
-        if(position.x > 1.8f)
-        {
-            position.x = -1.75f;
-        }
-        if(position.y < -1.01f)
+        if(recorder.recording)
         {
-            position.y = 0.9f;
+            recorder.Save(recordPath);
+            recorder.recording = false;
         }
-        if(position.y > 1.01f)
-        {
-            position.y = -0.9f;
-        }
-        matrix = glm::translate(matrix, position);
-        matrix = glm::rotate(matrix, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
     }
-    void setEdgeSet()
+    void command(SimulationCommand command)
     {
-        for(int add = 0; add < index.size(); add += 2)
-        {
-            edgeSet.push_back(glm::vec4(index[add], index[add+1], 1.0f, 1.0f));
-        }
+        GameRequest request;
+        request.kind = GameRequest::COMMAND;
+        request.command = command;
+        std::lock_guard<std::mutex> lock(requestLock);
+        requests.push_back(request);
     }
-    std::vector<glm::vec4> transformEdgeSet()
+    void setMode(GameState mode)
     {
-        std::vector<glm::vec4> temp;
-        for(glm::vec4& transform : edgeSet)
-        {
-            temp.push_back(matrix * transform);
-        }
-        return temp;
+        GameRequest request;
+        request.kind = GameRequest::MODE;
+        request.mode = mode;
+        std::lock_guard<std::mutex> lock(requestLock);
+        requests.push_back(request);
     }
-    void collisionUpdate(std::pair<float, float> penetration, int factor)
+    void setKeys(const Uint8* keys)
     {
-        position.x += penetration.first * 0.5f * factor;
-        position.y += penetration.second * 0.5f * factor;
-        //penetration contains overlap - penetration.first * 0.5 for x, penetration.second *0.5 on y
-        // and you move the other entity by negative penetration.first *0.5 and negative penetration.second *0.5
+        heldKeys = readInput(keys, sCodes[0]) | (readInput(keys, sCodes[1]) << INPUT_PLAYER_BITS);
     }
-    std::vector<glm::vec4> edgeSet;
-    std::vector<float> index;
-    glm::mat4 matrix;
-    glm::vec3 position;
-    glm::vec3 size;
-    float rotation;
-    float rotateAmount;
-    float moveSpeed;
-    float rotationSpeed;
-    
-    bool isEnable;
-    
-    glm::vec3 velocity;
-    
-    int health;
-};
-
-bool operator==(Asteroid& left, Asteroid& right)
-{
-    if(left.index.size() == right.index.size())
+    void simulationLoop()
     {
-        for(int check = 0; check < left.index.size(); check++)
+        FrameScheduler scheduler(timestep, MAX_TIMESTEPS);
+        double frequency = (double)SDL_GetPerformanceFrequency();
+        while(running)
         {
-            if(left.index[check] != right.index[check])
+            int steps = scheduler.BeginFrame();
+            applyRequests();
+            for(int step = 0; step < steps; step++)
             {
-                return false;
+                // shots pressed outside the game are dropped, as before
+                unsigned int shots = pendingShots.exchange(0);
+                if(gameMode == MAIN_GAME_SCREEN)
+                {
+                    Update(timestep, heldKeys | shots);
+                }
             }
-        }
-        if(left.matrix == right.matrix)
-        {
-            return true;
+            RenderSnapshot& snapshot = snapshots.Back();
+            capture(snapshot);
+            // the state is as of the last whole step, which ended a little before now
+            snapshot.stepTime = SDL_GetPerformanceCounter() - (Uint64)(scheduler.Alpha() * timestep * frequency);
+            snapshots.Publish();
         }
     }
-    return false;
-}
-bool operator!=(Asteroid& left, Asteroid& right)
-{
-    return !(left == right);
-}
-
-class Play
-{
-public:
-    Play(unsigned int texture)
-    {
-        p2Enable = false;
-        background = ParticleEmitter(glm::vec3(0.0f, 0.0f, 0.0f), -1, 5, 1000, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
-        screenShake = false;
-        screenTime = 0.0f;
-        player1 = Entity(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.132f, 0.1f, 0.0f), 0.0f, glm::vec3(1.0f, 1.0f, 1.0f), {SDL_SCANCODE_W, SDL_SCANCODE_S, SDL_SCANCODE_A, SDL_SCANCODE_D, SDL_SCANCODE_F}, PLAYER); // pos, size, rotation, up, down, rotateL, rotateR, Shoot
-        player2 = Entity(glm::vec3(0.25f, 0.0f, 0.0f), glm::vec3(0.132f, 0.1f, 0.0f), 0.0f, glm::vec3(1.0f, 1.0f, 1.0f), {SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT, SDL_SCANCODE_SPACE}, PLAYER);
-        player1.sprite = SheetSprite(texture, 0.0f/1024.0f, 941.0f/1024.0f, 112.0f/1024.0f, 75.0f/1024.0f, 0.1f);
-        player1.setEdgeSet();
-        player1.shootSound = Mix_LoadWAV(RESOURCE_FOLDER"shoot2.wav");
-        player1.hitSound = Mix_LoadWAV(RESOURCE_FOLDER"hit.wav");
-        player1.deathSound = Mix_LoadWAV(RESOURCE_FOLDER"death.wav");
-        player2.sprite = SheetSprite(texture, 112.0f/1024.0f, 791.0f/1024.0f, 112.0f/1024.0f, 75.0f/1024.0f, 0.1f);
-        player2.setEdgeSet();
-        player2.playerTag = 2;
-        player2.shootSound = Mix_LoadWAV(RESOURCE_FOLDER"shoot2.wav");
-        player2.hitSound = Mix_LoadWAV(RESOURCE_FOLDER"hit.wav");
-        player2.deathSound = Mix_LoadWAV(RESOURCE_FOLDER"death2.wav");
-        max_bullets = 20;
-        bulletIndex = 0;
-        bullets = std::vector<Entity>(max_bullets);
-        SheetSprite bulletSprite = SheetSprite(texture, 856.0f/1024.0f, 602.0f/1024.0f, 9.0f/1024.0f, 37.0f/1024.0f, 0.1f);
-        for(int i=0; i < max_bullets; i++)
-        {
-            bullets[i] = Entity(glm::vec3(0.0f, -20.0f, 0.0f), glm::vec3(0.1f, 0.1f, 0.0f), 0.0f, glm::vec3(0.5f, 0.5f, 0.0f), BULLET);
-            bullets[i].sprite = bulletSprite;
-            bullets[i].setEdgeSet();
-        }
-        possibleIndices.push_back({ -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f});
-        possibleIndices.push_back({ -0.4, -0.4f, 0.4f, -0.4f, 0.6f, 0.0f, 0.5f, 0.5f, -0.6f, 0.0f});
-        possibleIndices.push_back({ -0.5, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f});
-        possibleIndices.push_back({ -0.4f, -0.4f, 0.4f, -0.4f, 0.8f, 0.0f, 0.4f, 0.4f, -0.4f, 0.4f, -0.8f, 0.0f });
-        asteroidInitialization();
-        player1Score = 0;
-        player2Score = 0;
-        timer = 0.0f;
-    }
-    Entity player1;
-    Entity player2;
-    int player1Score;
-    int player2Score;
-    std::vector<Asteroid> asteroids;
-    int max_bullets;
-    int bulletIndex;
-    std::vector<Entity> bullets;
-    bool p2Enable;
-    bool screenShake;
-    float screenTime;
-    float timer;
-    ParticleEmitter background;
-    std::vector<ParticleEmitter> collisions;
-    std::vector<std::vector<float>> possibleIndices;
-    void player2Enable()
-    {
-        p2Enable = true;
-        player2.health = 5;
-        player1.position = glm::vec3(-0.25f, 0.0f, 0.0f);
-    }
-    void asteroidInitialization()
-    {
-        asteroids.clear();
-        for(int i = 0; i < 5; i++)
-        {
-            asteroidCreation();
-        }
-    }
-    void asteroidCreation()
-    {
-        float posX = -1.77f;
-        float posY = -1.0f;
-        if(genRandom(0, 1) > 0.5f)
-        {
-            posX = genRandom(1.5f, 1.75f);
-        }
-        else
-        {
-            posX = genRandom(-1.75f, -1.5f);
-        }
-        if(genRandom(0, 1) > 0.5f)
-        {
-            posY = genRandom(0.8f, 0.95f);
-        }
-        else
-        {
-            posY = genRandom(-0.95f, -0.8f);
-        }
-        int index = (int) (genRandom(0, 3.9));
-        asteroids.push_back(Asteroid(glm::vec3(posX, posY, 0.0f), glm::vec3(genRandom(0.1f, 0.6f), genRandom(0.1f, 1.0f), 0.5f),
-                            genRandom(0, 360), glm::vec3(genRandom(-0.75f, 0.55f), genRandom(-0.55f, 0.75f), 0.0f), possibleIndices[index]));
-    }
-    void Reset()
+    void applyRequests()
     {
-        player1.health = 5;
-        player2.health = 5;
-        player2.position = glm::vec3(0.25f, 0.0f, 0.0f);
-        player2.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-        player2.rotation = 0.0f;
-        if(p2Enable)
         {
-            player1.position = glm::vec3(-0.25f, 0.0f, 0.0f);
+            std::lock_guard<std::mutex> lock(requestLock);
+            applying.swap(requests);
         }
-        player1.position = glm::vec3(0.0f, 0.0f, 0.0f);
-        player1.rotation = 0.0f;
-        player1.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-        asteroids.clear();
-        for(int i = 0; i < 5; i++)
+        for(const GameRequest& request : applying)
         {
-            asteroidCreation();
+            if(request.kind == GameRequest::COMMAND)
+            {
+                recorder.Command(request.command);
+                sim.Apply(request.command);
+            }
+            else
+            {
+                gameMode = request.mode;
+            }
         }
+        applying.clear();
     }
-    void Render(ShaderProgram& program, ShaderProgram& untextProgram, glm::mat4 viewMatrix)
+    void capture(RenderSnapshot& snapshot)
     {
-        float screenShakeIntensity = 1.0f;
-        if(player1.health > 0)
-        {
-            screenShakeIntensity = 1/player1.health;
-        }
-        if(p2Enable && player1.health + player2.health > 0)
-        {
-            screenShakeIntensity = 1/(player1.health+player2.health);
-        }
+        snapshot.Capture(sim);
+        snapshot.timestep = timestep;
+        snapshot.mode = gameMode;
+        snapshot.screenShake = screenShake;
         if(screenShake)
         {
-            viewMatrix = glm::mat4(1.0f);
-            viewMatrix = glm::translate(viewMatrix, glm::vec3(cos(genRandom(0, 1)), sin(genRandom(0, 1))* screenShakeIntensity, 0.0f));
-            program.SetViewMatrix(viewMatrix);
-            untextProgram.SetViewMatrix(viewMatrix);
-        }
-        if(!screenShake)
-        {
-            viewMatrix = glm::mat4(1.0f);
-            viewMatrix = glm::translate(viewMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
-            program.SetViewMatrix(viewMatrix);
-            untextProgram.SetViewMatrix(viewMatrix);
-        }
-        glUseProgram(untextProgram.programID);
-        background.Render(untextProgram);
-        for(ParticleEmitter& emitters : collisions)
-        {
-            if(emitters.enable)
+            float screenShakeIntensity = 1.0f;
+            if(sim.player1.health > 0)
             {
-                emitters.Render(program);
+                screenShakeIntensity = 1/sim.player1.health;
             }
-        }
-        for(Asteroid& asteroid : asteroids)
-        {
-            if(asteroid.isEnable)
+            if(sim.p2Enable && sim.player1.health + sim.player2.health > 0)
             {
-                asteroid.Render(untextProgram);
+                screenShakeIntensity = 1/(sim.player1.health+sim.player2.health);
             }
+            snapshot.shakeOffset = glm::vec3(cos(genRandom(0, 1)), sin(genRandom(0, 1))* screenShakeIntensity, 0.0f);
         }
-        glUseProgram(program.programID);
-        player1.Render(program);
-        if(p2Enable)
-        {
-            player2.Render(program);
-        }
-        for(Entity& bullet : bullets)
+        // Only the game screen draws the emitters. The starfield never respawns,
+        // so once a snapshot holds its spawn data a GPU-evaluated one only needs
+        // the clock; assignment keeps the snapshot's own GL buffers.
+        if(gameMode == MAIN_GAME_SCREEN)
         {
-            bullet.Render(program);
+            if(background.gpuEvaluated && snapshot.background.gpuEvaluated)
+            {
+                snapshot.background.CopyClockFrom(background);
+            }
+            else
+            {
+                snapshot.background = background;
+            }
+            snapshot.collisions = collisions;
         }
-
     }
-    void Update(float elapsed)
+    void Update(float elapsed, unsigned int bits)
     {
-        timer += elapsed;
-        if(timer > genRandom(2, 4))
-        {
-            asteroidCreation();
-            timer = 0.0f;
-        }
         screenTime += elapsed;
         if(screenTime > 0.25f)
         {
             screenShake = false;
             screenTime = 0.0f;
         }
-        background.Update(elapsed);
-        for(ParticleEmitter& emitter : collisions)
-        {
-            if(emitter.enable)
-            {
-                emitter.Update(elapsed);
-            }
-        }
-        for(Asteroid& check : asteroids)
+        background.Update(elapsed, &jobs);
+        collisions.Update(elapsed, &jobs);
+        recorder.Step(bits);
+        sim.Step(bits, elapsed);
+        recorder.StepDone(sim);
+        handleEvents();
+        audio.EndFrame();
+    }
+    void handleEvents()
+    {
+        for(const SimulationEvent& event : sim.events)
         {
-            if(!check.isEnable)
-            {
-                continue;
-            }
-            std::pair<float,float> penetration;
-            if(CheckSATCollision(floatPairs(check.transformEdgeSet()), floatPairs(player1.transformEdgeSet()), penetration))
-            {
-                screenShake = true;
-                player1.collisionUpdate();
-                check.isEnable = false;
-            }
-            if(!check.isEnable)
+            switch(event.type)
             {
-                continue;
-            }
-            if(p2Enable)
-            {
-                if(CheckSATCollision(floatPairs(check.transformEdgeSet()), floatPairs(player2.transformEdgeSet()), penetration))
-                {
-                    std::cout << penetration.first << " " << penetration.second << " " << timer << std::endl;
+                case SHOT_FIRED:
+                    audio.Play(shootSound);
+                    break;
+                case PLAYER_HIT:
                     screenShake = true;
-                    player2.collisionUpdate();
-                    check.isEnable = false;
-                }
-            }
-            if(!check.isEnable)
-            {
-                continue;
-            }
-            for(Entity& bullet : bullets)
-            {
-                if(bullet.position.y != -20.0f)
-                {
-                    if(CheckSATCollision(floatPairs(check.transformEdgeSet()), floatPairs(bullet.transformEdgeSet()), penetration))
-                    {
-                        if(bullet.playerTag == 1)
-                        {
-                            player1Score += 10;
-                        }
-                        if(bullet.playerTag == 2)
-                        {
-                            player2Score += 10;
-                        }
-                        check.isEnable = false;
-                        bullet.collisionUpdate();
-                    }
-                }
-            }
-            if(!check.isEnable)
-            {
-                continue;
-            }
-            for(Asteroid& asteroid : asteroids)
-            {
-                if(asteroid != check && asteroid.isEnable)
-                {
-                    if(CheckSATCollision(floatPairs(check.transformEdgeSet()), floatPairs(asteroid.transformEdgeSet()), penetration))
-                    {
-                        check.collisionUpdate(penetration, 1);
-                        asteroid.collisionUpdate(penetration, -1);
-                        float xPos = check.position.x - penetration.first*50*check.size.x;
-                        float yPos = check.position.y - penetration.second*50*check.size.y;
-                        collisions.push_back(ParticleEmitter(glm::vec3(xPos, yPos, 0.0f), 1.0f, 1.0f, 50, glm::vec4(1.0f, 0.5f, 0.0f, 1.0f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));
-                    }
-                }
-            }
-        }
-        player1.Update(elapsed);
-        if(player1.health <= 0)
-        {
-            Mix_PlayChannel(-1, player1.deathSound, 0);
-            gameMode = END_GAME_SCREEN;
-            Reset();
-        }
-        if(p2Enable)
-        {
-            player2.Update(elapsed);
-            if(player2.health <= 0)
-            {
-                Mix_PlayChannel(-1, player2.deathSound, 0);
-                gameMode = END_GAME_SCREEN;
-                Reset();
+                    audio.Play(hitSound);
+                    break;
+                case PLAYER_DIED:
+                    audio.Play(deathSound[event.player-1]);
+                    break;
+                case ASTEROIDS_COLLIDED:
+                    collisions.Emit(event.position);
+                    break;
+                case GAME_OVER:
+                    gameMode = END_GAME_SCREEN;
+                    break;
             }
         }
-        bool gameOverTest = true;
-        for(Asteroid& asteroid : asteroids)
+        sim.events.clear();
+    }
+    void shoot(int player)
+    {
+        // fired on the next step so a replay can put it on the same frame
+        pendingShots.fetch_or(INPUT_SHOOT << (player == 2 ? INPUT_PLAYER_BITS : 0));
+    }
+    unsigned int readInput(const Uint8* keys, const std::vector<SDL_Scancode>& codes)
+    {
+        unsigned int bits = 0;
+        if(keys[codes[0]])
         {
-            if(asteroid.isEnable)
-            {
-                gameOverTest = false;
-                asteroid.Update(elapsed);
-            }
+            bits |= INPUT_FORWARD;
         }
-        if(gameOverTest)
+        if(keys[codes[1]])
         {
-            gameMode = END_GAME_SCREEN;
-            Reset();
+            bits |= INPUT_BACKWARD;
         }
-        for(Entity& bullet : bullets)
+        if(keys[codes[2]])
         {
-            bullet.Update(elapsed);
+            bits |= INPUT_ROTATE_LEFT;
         }
-    }
-    void shoot(Entity& entity)
-    {
-        if(entity.shoot)
+        if(keys[codes[3]])
         {
-            Mix_PlayChannel(-1, entity.shootSound, 0);
-            bullets[bulletIndex].position = entity.position;
-            bullets[bulletIndex].velocity = glm::vec3(cos(entity.rotation+glm::pi<float>()/2)*2.5f, sin(entity.rotation+glm::pi<float>()/2)*2.5f, 0.0f);
-            bullets[bulletIndex].rotation = entity.rotation;
-            bullets[bulletIndex].playerTag = entity.playerTag;
-            bulletIndex++;
-            if(bulletIndex >= max_bullets)
-            {
-                bulletIndex = 0;
-            }
-            entity.shoot = false;
+            bits |= INPUT_ROTATE_RIGHT;
         }
-    }
-    void ProcessInput(const Uint8* keys)
-    {
-        player1.Process(keys);
-        player2.Process(keys);
+        return bits;
     }
 private:
 };
@@ -795,120 +490,194 @@ private:
 class Menu
 {
 public:
+    Menu() {}
     void MainMenuRender(ShaderProgram& program, int fontSheet)
     {
-        DrawText(program, fontSheet, "Asteroids", 0.25f, 0.0005f, glm::vec3(-1.0f, 0.7f, 0.0f));
-        DrawText(program, fontSheet, "1 Player", 0.15f, 0.00005f, glm::vec3(-1.5f, -0.75f, 0.0f));
-        DrawText(program, fontSheet, "2 Player", 0.15f, 0.00005f, glm::vec3(0.25f, -0.75f, 0.0f));
+        text.Begin();
+        text.Draw(fontSheet, "Asteroids", 0.25f, 0.0005f, glm::vec3(-1.0f, 0.7f, 0.0f));
+        text.Draw(fontSheet, "1 Player", 0.15f, 0.00005f, glm::vec3(-1.5f, -0.75f, 0.0f));
+        text.Draw(fontSheet, "2 Player", 0.15f, 0.00005f, glm::vec3(0.25f, -0.75f, 0.0f));
+        text.End(program);
     }
-    void InstructionsRender(ShaderProgram& program, int fontSheet, Play& game)
+    void InstructionsRender(ShaderProgram& program, int fontSheet, const RenderSnapshot& frame)
     {
-        DrawText(program, fontSheet, "Instructions:", 0.25f, 0.0005f, glm::vec3(-1.5f, 0.7f, 0.0f));
-        if(game.p2Enable)
+        text.Begin();
+        text.Draw(fontSheet, "Instructions:", 0.25f, 0.0005f, glm::vec3(-1.5f, 0.7f, 0.0f));
+        if(frame.p2Enable)
         {
-            DrawText(program, fontSheet, "Player 1:", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.5f, 0.0f));
-            DrawText(program, fontSheet, "Move Forward:W", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.35f, 0.0f));
-            DrawText(program, fontSheet, "Move Backward:S", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.2f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Left:A", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.05f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Right:D", 0.1f, 0.000000001f, glm::vec3(-1.7f, -0.1f, 0.0f));
+            text.Draw(fontSheet, "Player 1:", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.5f, 0.0f));
+            text.Draw(fontSheet, "Move Forward:W", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.35f, 0.0f));
+            text.Draw(fontSheet, "Move Backward:S", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.2f, 0.0f));
+            text.Draw(fontSheet, "Rotate Left:A", 0.1f, 0.000000001f, glm::vec3(-1.7f, 0.05f, 0.0f));
+            text.Draw(fontSheet, "Rotate Right:D", 0.1f, 0.000000001f, glm::vec3(-1.7f, -0.1f, 0.0f));
             
-            DrawText(program, fontSheet, "Player 2:", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.5f, 0.0f));
-            DrawText(program, fontSheet, "Move Forward:Up", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.35f, 0.0f));
-            DrawText(program, fontSheet, "Move Backward:Down", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.2f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Left:Left", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.05f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Right:Right", 0.1f, 0.000000001f, glm::vec3(-0.1f, -0.1f, 0.0f));
+            text.Draw(fontSheet, "Player 2:", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.5f, 0.0f));
+            text.Draw(fontSheet, "Move Forward:Up", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.35f, 0.0f));
+            text.Draw(fontSheet, "Move Backward:Down", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.2f, 0.0f));
+            text.Draw(fontSheet, "Rotate Left:Left", 0.1f, 0.000000001f, glm::vec3(-0.1f, 0.05f, 0.0f));
+            text.Draw(fontSheet, "Rotate Right:Right", 0.1f, 0.000000001f, glm::vec3(-0.1f, -0.1f, 0.0f));
         }
         else
         {
-            DrawText(program, fontSheet, "Move Forward:W", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.35f, 0.0f));
-            DrawText(program, fontSheet, "Move Backward:S", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.2f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Left:A", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.05f, 0.0f));
-            DrawText(program, fontSheet, "Rotate Right:D", 0.15f, 0.000000001f, glm::vec3(-1.25f, -0.1f, 0.0f));
+            text.Draw(fontSheet, "Move Forward:W", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.35f, 0.0f));
+            text.Draw(fontSheet, "Move Backward:S", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.2f, 0.0f));
+            text.Draw(fontSheet, "Rotate Left:A", 0.15f, 0.000000001f, glm::vec3(-1.25f, 0.05f, 0.0f));
+            text.Draw(fontSheet, "Rotate Right:D", 0.15f, 0.000000001f, glm::vec3(-1.25f, -0.1f, 0.0f));
         }
-        DrawText(program, fontSheet, "Press Q to Quit", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.35f, 0.0f));
-        DrawText(program, fontSheet, "Continue to Game", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.55f, 0.0f));
-        DrawText(program, fontSheet, "Return to Main Menu", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.75f, 0.0f));
-        
+        text.Draw(fontSheet, "Press Q to Quit", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.35f, 0.0f));
+        text.Draw(fontSheet, "Continue to Game", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.55f, 0.0f));
+        text.Draw(fontSheet, "Return to Main Menu", 0.15f, 0.00005f, glm::vec3(-1.25f, -0.75f, 0.0f));
+        text.End(program);
     }
-    void InstructionsProcess(float xPos, float yPos)
+    void InstructionsProcess(float xPos, float yPos, Play& game)
     {
         if(xPos > -1.25 && xPos < 1.25 && yPos <-0.55 && yPos > -0.75)
         {
-            gameMode = MAIN_GAME_SCREEN;
+            game.setMode(MAIN_GAME_SCREEN);
         }
         if(xPos > -1.25 && xPos < 1.25 && yPos <-0.75)
         {
-            gameMode = START_SCREEN;
+            game.setMode(START_SCREEN);
         }
     }
 
-    void EndMenuRender(ShaderProgram& program, int fontSheet, Play& game)
+    void EndMenuRender(ShaderProgram& program, int fontSheet, const RenderSnapshot& frame)
     {
-        if(game.p2Enable)
+        text.Begin();
+        if(frame.p2Enable)
         {
-            if(game.player1.health > 0 && game.player2.health > 0)
+            if(frame.player1Health > 0 && frame.player2Health > 0)
             {
-                DrawText(program, fontSheet, "You Survived!", 0.25f, 0.000005f, glm::vec3(-1.5f, 0.7f, 0.0f));
+                text.Draw(fontSheet, "You Survived!", 0.25f, 0.000005f, glm::vec3(-1.5f, 0.7f, 0.0f));
             }
             else
             {
-                DrawText(program, fontSheet, "You Died!", 0.25f, 0.0005f, glm::vec3(-1.0f, 0.7f, 0.0f));
+                text.Draw(fontSheet, "You Died!", 0.25f, 0.0005f, glm::vec3(-1.0f, 0.7f, 0.0f));
             }
-            DrawText(program, fontSheet, "Score: ", 0.15, 0.0005f, glm::vec3(-0.8f, 0.5f, 0.0f));
-            DrawText(program, fontSheet, "Player1: ", 0.15f, 0.0005f, glm::vec3(-0.8f, 0.3f, 0.0f));
-            DrawText(program, fontSheet, std::to_string(game.player1Score), 0.2f, 0.0005f, glm::vec3(0.4f, 0.3f, 0.0f));
-            DrawText(program, fontSheet, "Player2: ", 0.15f, 0.0005f, glm::vec3(-0.8f, 0.1f, 0.0f));
-            DrawText(program, fontSheet, std::to_string(game.player2Score), 0.2f, 0.0005f, glm::vec3(0.4f, 0.1f, 0.0f));
+            text.Draw(fontSheet, "Score: ", 0.15, 0.0005f, glm::vec3(-0.8f, 0.5f, 0.0f));
+            text.Draw(fontSheet, "Player1: ", 0.15f, 0.0005f, glm::vec3(-0.8f, 0.3f, 0.0f));
+            text.Draw(fontSheet, frame.player1ScoreText, 0.2f, 0.0005f, glm::vec3(0.4f, 0.3f, 0.0f));
+            text.Draw(fontSheet, "Player2: ", 0.15f, 0.0005f, glm::vec3(-0.8f, 0.1f, 0.0f));
+            text.Draw(fontSheet, frame.player2ScoreText, 0.2f, 0.0005f, glm::vec3(0.4f, 0.1f, 0.0f));
         }
         else
         {
-            if(game.player1.health > 0)
+            if(frame.player1Health > 0)
             {
-                DrawText(program, fontSheet, "You Survived!", 0.25f, 0.000005f, glm::vec3(-1.5f, 0.7f, 0.0f));
+                text.Draw(fontSheet, "You Survived!", 0.25f, 0.000005f, glm::vec3(-1.5f, 0.7f, 0.0f));
             }
             else
             {
-                DrawText(program, fontSheet, "You Died!", 0.25f, 0.000005f, glm::vec3(-1.0f, 0.7f, 0.0f));
+                text.Draw(fontSheet, "You Died!", 0.25f, 0.000005f, glm::vec3(-1.0f, 0.7f, 0.0f));
             }
-            DrawText(program, fontSheet, "Score: ", 0.15, 0.0005f, glm::vec3(-0.6f, 0.3f, 0.0f));
-            DrawText(program, fontSheet, std::to_string(game.player1Score), 0.2f, 0.0005f, glm::vec3(0.3f, 0.3f, 0.0f));
+            text.Draw(fontSheet, "Score: ", 0.15, 0.0005f, glm::vec3(-0.6f, 0.3f, 0.0f));
+            text.Draw(fontSheet, frame.player1ScoreText, 0.2f, 0.0005f, glm::vec3(0.3f, 0.3f, 0.0f));
         }
-        DrawText(program, fontSheet, "Replay", 0.15f, 0.00005f, glm::vec3(-0.5f, -0.45f, 0.0f));
-        DrawText(program, fontSheet, "Return to Start", 0.15f, 0.00005f, glm::vec3(-1.0f, -0.75f, 0.0f));
+        text.Draw(fontSheet, "Replay", 0.15f, 0.00005f, glm::vec3(-0.5f, -0.45f, 0.0f));
+        text.Draw(fontSheet, "Return to Start", 0.15f, 0.00005f, glm::vec3(-1.0f, -0.75f, 0.0f));
+        text.End(program);
     }
     void MainMenuProcess(float xPos, float yPos, Play& game)
     {
         if(xPos > 0.0f && yPos < 0.0f)
         {
-            game.player2Enable();
-            gameMode = INSTRUCTION_SCREEN;
+            game.command(COMMAND_ENABLE_PLAYER2);
+            game.setMode(INSTRUCTION_SCREEN);
         }
         if(xPos < 0.0f && yPos < 0.0f)
         {
-            gameMode = INSTRUCTION_SCREEN;
+            game.setMode(INSTRUCTION_SCREEN);
         }
     }
     void EndMenuProcess(float xPos, float yPos, Play& game)
     {
         if(yPos > -0.5f && yPos < 0.0f)
         {
-            game.player1Score = 0;
-            game.player2Score = 0;
-            gameMode = MAIN_GAME_SCREEN;
+            game.command(COMMAND_NEW_GAME);
+            game.setMode(MAIN_GAME_SCREEN);
         }
         if(yPos < -0.5f)
         {
-            game.player1Score = 0;
-            game.player2Score = 0;
-            game.p2Enable = false;
-            gameMode = START_SCREEN;
+            game.command(COMMAND_RETURN_TO_START);
+            game.setMode(START_SCREEN);
         }
     }
+    const TextCache& Text() const
+    {
+        return text;
+    }
 private:
+    TextCache text;
 };
 
 int main(int argc, char *argv[])
 {
+    Uint64 launchTime = SDL_GetPerformanceCounter();
+    // --startup-timing prints how long the assets, the first frame and the music took to arrive
+    bool startupTiming = false;
+    // --no-texture-cache decodes every image as if for the first time, for comparing startup times
+    bool textureCache = true;
+    // --replay file re-simulates a recording headless and exits; --record file saves one on quit
+    std::string recordPath;
+    std::string replayPath;
+    unsigned int seed = (unsigned int)time(NULL);
+    FramePacing pacing = PACING_SLEEP_SPIN;
+    // --sim-rate 30 halves the simulation cost on slow machines; rendering blends between steps
+    float timestep = FIXED_TIMESTEP;
+    // --workers N sets how many job threads help the simulation; by default one
+    // core each is left for the render and simulation threads
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    int workers = hardwareThreads > 2 ? hardwareThreads - 2 : 0;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replayPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--vsync") == 0)
+        {
+            pacing = PACING_VSYNC;
+        }
+        else if(strcmp(argv[i], "--sim-rate") == 0 && i + 1 < argc)
+        {
+            float rate = (float)atof(argv[++i]);
+            if(rate > 0.0f)
+            {
+                timestep = 1.0f / rate;
+            }
+        }
+        else if(strcmp(argv[i], "--startup-timing") == 0)
+        {
+            startupTiming = true;
+        }
+        else if(strcmp(argv[i], "--no-texture-cache") == 0)
+        {
+            textureCache = false;
+        }
+        else if(strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+        {
+            workers = atoi(argv[++i]);
+        }
+    }
+    if(!replayPath.empty())
+    {
+        ReplayPlayer replay;
+        if(!replay.Load(replayPath))
+        {
+            return 1;
+        }
+        ReplayResult result = replay.Run();
+        PrintReplayResult(result);
+        return result.mismatches == 0 ? 0 : 2;
+    }
     float screenWidth = 640;
     float screenHeight = 360;
     SDL_Init(SDL_INIT_VIDEO);
@@ -918,9 +687,7 @@ int main(int argc, char *argv[])
     
     ShaderProgram program;
     ShaderProgram programU;
-    
-    program.Load(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl");
-    programU.Load(RESOURCE_FOLDER"vertex.glsl", RESOURCE_FOLDER"fragment.glsl");
+    ParticleProgram programP;
     
     glm::mat4 projectionMatrix = glm::mat4(1.0f);
     
@@ -931,218 +698,238 @@ int main(int argc, char *argv[])
     float projectionDepth = 1.0f;
     projectionMatrix = glm::ortho(-projectionWidth, projectionWidth, -projectionHeight, projectionHeight,
                                   -projectionDepth, projectionDepth);
-    program.SetProjectionMatrix(projectionMatrix);
-    programU.SetProjectionMatrix(projectionMatrix);
-    
     glm::mat4 viewMatrix = glm::mat4(1.0f);
-    program.SetViewMatrix(viewMatrix);
-    programU.SetViewMatrix(viewMatrix);
     
-    Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 4096 );
-    Mix_Music* music;
-    music = Mix_LoadMUS(RESOURCE_FOLDER"bensound-deepblue.mp3");
-    Mix_PlayMusic(music, -1);
+    // a short device buffer keeps effects close to the frame that caused them; AudioMixer keeps a lead of its own
+    Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 1024 );
+    // opened once the first frame is up, and loaded off the main thread
+    MusicStream music;
+    double firstFrameMs = -1.0;
+    double assetsReadyMs = -1.0;
     
-    GLuint fontSheet = LoadTexture(RESOURCE_FOLDER"font1.png", 1);
-    GLuint spriteSheet = LoadTexture(RESOURCE_FOLDER"sheet.png", 1);
-    
-    srand(time(NULL));
-    
-
-
 #ifdef _WINDOWS
     glewInit();
 #endif
     
-    const Uint8 *keys = SDL_GetKeyboardState(NULL);
-
-    Menu menus;
-    Play game(spriteSheet);
-    float lastFrameTicks = 0.0f;
+    // Everything is decoded on worker threads while the loading screen runs; only
+    // the GL uploads and shader links come back to this thread. The untextured
+    // shader goes first so the loading bar can be drawn as early as possible.
+    SoundBank soundBank;
+    // decoded textures are kept in the app's preferences folder for the next launch
+    std::string textureCachePath;
+    char* prefPath = textureCache ? SDL_GetPrefPath("NYU", "NYUCodebase") : NULL;
+    if(prefPath)
+    {
+        textureCachePath = prefPath;
+        SDL_free(prefPath);
+    }
+    AssetManager assets(hardwareThreads > 1 ? hardwareThreads - 1 : 1, textureCachePath);
+    AssetHandle untexturedShader = assets.LoadShader(RESOURCE_FOLDER"vertex.glsl", RESOURCE_FOLDER"fragment.glsl",
+        [&programU](const std::string& vertex, const std::string& fragment) { return programU.LoadFromSource(vertex, fragment); });
+    assets.LoadShader(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl",
+        [&program](const std::string& vertex, const std::string& fragment) { return program.LoadFromSource(vertex, fragment); });
+    assets.LoadShader(RESOURCE_FOLDER"vertex_particle.glsl", RESOURCE_FOLDER"fragment_particle.glsl",
+        [&programP](const std::string& vertex, const std::string& fragment) { return programP.LoadFromSource(vertex, fragment); });
+    AssetHandle fontHandle = assets.LoadTexture(RESOURCE_FOLDER"font1.png", true);
+    AssetHandle spriteHandle = assets.LoadTexture(RESOURCE_FOLDER"sheet.png", true);
+#ifdef DEBUG
+    assets.Load([]() { return sheetAtlas.Load(RESOURCE_FOLDER"sheet.xml", 1024.0f, 1024.0f); });
+#endif
+    // Each load keeps its reference only until the game has taken its own, so
+    // the sounds are freed when the game releases them.
+    const char* soundFiles[] = {RESOURCE_FOLDER"shoot2.wav", RESOURCE_FOLDER"hit.wav", RESOURCE_FOLDER"death.wav", RESOURCE_FOLDER"death2.wav"};
+    Mix_Chunk* loadedSounds[4] = {NULL, NULL, NULL, NULL};
+    for(int i = 0; i < 4; i++)
+    {
+        std::string path = soundFiles[i];
+        Mix_Chunk** loaded = &loadedSounds[i];
+        assets.Load([&soundBank, path, loaded]() { *loaded = soundBank.Acquire(path); return *loaded != NULL; });
+    }
     
-    // 60 FPS (1.0f/60.0f) (update sixty times a second)
-#define FIXED_TIMESTEP 0.0166666f
-#define MAX_TIMESTEPS 6
-    float accumulator = 0.0f;
+    srand(time(NULL));
+    
+    // paces drawing only; the simulation thread keeps its own clock at the sim rate
+    FrameScheduler display(FIXED_TIMESTEP, 1);
+    display.SetPacing(pacing);
+    double frequency = (double)SDL_GetPerformanceFrequency();
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glUseProgram(program.programID);
     SDL_Event event;
     bool done = false;
-    while (!done) {
+    // a quit while loading is honored once the remaining assets are in
+    display.Reset();
+    while(!assets.Done())
+    {
+        display.BeginFrame();
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
                 done = true;
             }
-            else if(event.type == SDL_MOUSEBUTTONDOWN)
-            {
-                float unitX = (((float)event.motion.x / 640.0f) * 3.554f ) - 1.777f;
-                float unitY = (((float)(360-event.motion.y) / 360.0f) * 2.0f ) - 1.0f;
-                if(event.button.button == SDL_BUTTON_LEFT)
-                {
-                    switch (gameMode) {
-                        case START_SCREEN:
-                            menus.MainMenuProcess(unitX, unitY, game);
-                            break;
-                        case INSTRUCTION_SCREEN:
-                            menus.InstructionsProcess(unitX, unitY);
-                            break;
-                        case MAIN_GAME_SCREEN: break;
-                        case END_GAME_SCREEN:
-                            menus.EndMenuProcess(unitX, unitY, game);
-                            break;
-                    }
+        }
+        assets.Update(ASSET_UPLOAD_BUDGET);
+        glClear(GL_COLOR_BUFFER_BIT);
+        if(assets.State(untexturedShader) == ASSET_READY)
+        {
+            programU.SetProjectionMatrix(projectionMatrix);
+            programU.SetViewMatrix(viewMatrix);
+            programU.SetColor(1.0f, 1.0f, 1.0f, 1.0f);
+            DrawLoadingBar(programU, assets.Progress().fraction);
+        }
+        SDL_GL_SwapWindow(displayWindow);
+    }
+    assetsReadyMs = (SDL_GetPerformanceCounter() - launchTime) * 1000.0 / frequency;
+    GLuint fontSheet = assets.Texture(fontHandle);
+    GLuint spriteSheet = assets.Texture(spriteHandle);
+    
+    program.SetProjectionMatrix(projectionMatrix);
+    programU.SetProjectionMatrix(projectionMatrix);
+    programP.program.SetProjectionMatrix(projectionMatrix);
+    
+    program.SetViewMatrix(viewMatrix);
+    programU.SetViewMatrix(viewMatrix);
+    programP.program.SetViewMatrix(viewMatrix);
+    
+    const Uint8 *keys = SDL_GetKeyboardState(NULL);
+
+    // The menus' text cache and the game's emitters own GL buffers, so both
+    // have to go while the context is still current; the audio the game
+    // drives closes with it.
+    {
+        Menu menus;
+        Play game(spriteSheet, seed, workers, soundBank);
+        for(Mix_Chunk* chunk : loadedSounds)
+        {
+            soundBank.Release(chunk);
+        }
+        game.timestep = timestep;
+        if(!recordPath.empty())
+        {
+            game.startRecording(recordPath);
+        }
+        // the starfield is animated in vertex_particle.glsl unless that shader failed to link
+        game.background.gpuEvaluated = programP.linked;
+
+        glUseProgram(program.programID);
+#ifdef DEBUG
+        // the sprite batch's and the menus' text cache's counters are printed once a second
+        Uint32 lastStatsTicks = SDL_GetTicks();
+#endif
+        game.Start();
+        display.Reset();
+        while (!done) {
+            display.BeginFrame();
+            game.snapshots.Acquire();
+            RenderSnapshot& frame = game.snapshots.Front();
+            GameState mode = (GameState)frame.mode;
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
+                    done = true;
                 }
-            }
-            else if (event.type == SDL_KEYDOWN)
-            {
-                if(event.key.keysym.scancode == game.player1.sCodes[4])
+                else if(event.type == SDL_MOUSEBUTTONDOWN)
                 {
-                    game.shoot(game.player1);
+                    float unitX = (((float)event.motion.x / 640.0f) * 3.554f ) - 1.777f;
+                    float unitY = (((float)(360-event.motion.y) / 360.0f) * 2.0f ) - 1.0f;
+                    if(event.button.button == SDL_BUTTON_LEFT)
+                    {
+                        switch (mode) {
+                            case START_SCREEN:
+                                menus.MainMenuProcess(unitX, unitY, game);
+                                break;
+                            case INSTRUCTION_SCREEN:
+                                menus.InstructionsProcess(unitX, unitY, game);
+                                break;
+                            case MAIN_GAME_SCREEN: break;
+                            case END_GAME_SCREEN:
+                                menus.EndMenuProcess(unitX, unitY, game);
+                                break;
+                        }
+                    }
                 }
-                if(event.key.keysym.scancode == game.player2.sCodes[4])
+                else if (event.type == SDL_KEYDOWN)
                 {
-                    game.shoot(game.player2);
+                    if(event.key.keysym.scancode == game.sCodes[0][4])
+                    {
+                        game.shoot(1);
+                    }
+                    if(event.key.keysym.scancode == game.sCodes[1][4])
+                    {
+                        game.shoot(2);
+                    }
                 }
             }
-        }
-        glClear(GL_COLOR_BUFFER_BIT);
-        
-        float ticks = (float)SDL_GetTicks()/1000.0f;
-        float elapsed = ticks - lastFrameTicks;
-        lastFrameTicks = ticks;
-        elapsed += accumulator;
-        if(elapsed < FIXED_TIMESTEP)
-        {
-            accumulator = elapsed;
-            continue;
-        }
-        while(elapsed >= FIXED_TIMESTEP)
-        {
-            if(keys[SDL_SCANCODE_M])
+            game.setKeys(keys);
+            if(keys[SDL_SCANCODE_M] && mode != START_SCREEN)
             {
-                gameMode = START_SCREEN;
+                game.setMode(START_SCREEN);
             }
             if(keys[SDL_SCANCODE_Q])
             {
-                exit(0);
+                done = true;
+            }
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            float alpha = 1.0f;
+            if(frame.valid)
+            {
+                alpha = (float)((SDL_GetPerformanceCounter() - frame.stepTime) / frequency / frame.timestep);
+                alpha = alpha > 1.0f ? 1.0f : alpha;
             }
-            switch(gameMode)
+            switch(mode)
             {
-                case START_SCREEN: break;
-                case INSTRUCTION_SCREEN: break;
+                case START_SCREEN:
+                    menus.MainMenuRender(program, fontSheet);
+                    break;
+                case INSTRUCTION_SCREEN:
+                    menus.InstructionsRender(program, fontSheet, frame);
+                    break;
                 case MAIN_GAME_SCREEN:
-                    game.Update(FIXED_TIMESTEP);
+                    game.Render(frame, program, programU, programP, viewMatrix, alpha);
+                    break;
+                case END_GAME_SCREEN:
+                    menus.EndMenuRender(program, fontSheet, frame);
                     break;
-                case END_GAME_SCREEN: break;
             }
-            elapsed -= FIXED_TIMESTEP;
-        }
-        accumulator = elapsed;
-        
-        if(keys[SDL_SCANCODE_M])
-        {
-            gameMode = START_SCREEN;
-        }
-        if(keys[SDL_SCANCODE_Q])
-        {
-            exit(0);
-        }
-        switch(gameMode)
-        {
-            case START_SCREEN:
-                menus.MainMenuRender(program, fontSheet);
-                break;
-            case INSTRUCTION_SCREEN:
-                menus.InstructionsRender(program, fontSheet, game);
-                break;
-            case MAIN_GAME_SCREEN:
-                game.ProcessInput(keys);
-                game.Render(program, programU, viewMatrix);
-                break;
-            case END_GAME_SCREEN:
-                menus.EndMenuRender(program, fontSheet, game);
-                break;
+            SDL_GL_SwapWindow(displayWindow);
+            if(firstFrameMs < 0.0)
+            {
+                firstFrameMs = (SDL_GetPerformanceCounter() - launchTime) * 1000.0 / frequency;
+                music.Start(RESOURCE_FOLDER"bensound-deepblue.mp3", MUS_MP3, -1);
+            }
+#ifdef DEBUG
+            if(SDL_GetTicks() - lastStatsTicks >= 1000)
+            {
+                printf("sprites: %d in %d draw calls; text: %d draw calls, %d runs laid out, %s\n", game.sprites.spriteCount,
+                       game.sprites.drawCalls, menus.Text().drawCalls, menus.Text().runsBuilt, menus.Text().uploaded ? "uploaded" : "reused");
+                lastStatsTicks = SDL_GetTicks();
+            }
+#endif
         }
-        SDL_GL_SwapWindow(displayWindow);
+
+        game.Stop();
+        if(startupTiming)
+        {
+            MusicStats musicStats = music.Stats();
+            AssetProgress loaded = assets.Progress();
+            printf("startup: %d assets ready at %.1f ms (%d failed, %d textures from the cache, %d decoded); first frame at %.1f ms; music opened %.1f ms, first chunk %.1f ms, playing %.1f ms after that; %u bytes prefetched, %u read on a miss\n",
+                   loaded.ready, assetsReadyMs, loaded.failed, assets.Textures().hits.load(), assets.Textures().misses.load(),
+                   firstFrameMs, musicStats.openMicros / 1000.0, musicStats.firstChunkMicros / 1000.0, musicStats.playingMicros / 1000.0,
+                   musicStats.bytesPrefetched, musicStats.bytesMissed);
+        }
+        music.Stop();
+        game.finishRecording();
+        game.audio.Close();
+#ifdef DEBUG
+        AudioStats audioStats = game.audio.Stats();
+        const VoiceStats& voiceStats = game.audio.VoiceCounts();
+        printf("audio: %u frames mixed, %u underruns, command queue peaked at %d, %u commands dropped; %u sounds played, %u merged, %u capped, %u stolen, %u dropped\n",
+               audioStats.mixedFrames, audioStats.underruns, audioStats.queueHighWater, audioStats.queueFull,
+               voiceStats.played, voiceStats.merged, voiceStats.capped, voiceStats.stolen, voiceStats.dropped);
+#endif
     }
-    
+    soundBank.Clear();
+    Mix_CloseAudio();
+    SDL_GL_DeleteContext(context);
     SDL_Quit();
     return 0;
 }
-
-GLuint LoadTexture(const char *filePath, int near) {
-    int w,h,comp;
-    unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-    if(image == NULL) {
-        std::cout << "Unable to load image. Make sure the path is correct\n";
-        assert(false);
-    }
-    GLuint retTexture;
-    glGenTextures(1, &retTexture);
-    glBindTexture(GL_TEXTURE_2D, retTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    if(near)
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    }
-    else
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    stbi_image_free(image);
-    return retTexture;
-}
-
-void DrawText(ShaderProgram &program, int fontTexture, std::string text, float size, float spacing, glm::vec3 position) {
-    glm::mat4 textMatrix = glm::mat4(1.0f);
-    textMatrix = glm::translate(textMatrix, position);
-    program.SetModelMatrix(textMatrix);
-    float character_size = 1.0/16.0f;
-    std::vector<float> vertexData;
-    std::vector<float> texCoordData;
-    for(int i=0; i < text.size(); i++) {
-        int spriteIndex = (int)text[i];
-        float texture_x = (float)(spriteIndex % 16) / 16.0f;
-        float texture_y = (float)(spriteIndex / 16) / 16.0f;
-        vertexData.insert(vertexData.end(), {
-            ((size+spacing) * i) + (-0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (-0.5f * size), -0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), -0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (-0.5f * size), -0.5f * size,
-        });
-        texCoordData.insert(texCoordData.end(), {
-            texture_x, texture_y,
-            texture_x, texture_y + character_size,
-            texture_x + character_size, texture_y,
-            texture_x + character_size, texture_y + character_size,
-            texture_x + character_size, texture_y,
-            texture_x, texture_y + character_size,
-        }); }
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
-    
-    program.SetModelMatrix(textMatrix);
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertexData.data());
-    glEnableVertexAttribArray(program.positionAttribute);
-    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoordData.data());
-    glEnableVertexAttribArray(program.texCoordAttribute);
-    glDrawArrays(GL_TRIANGLES, 0, (int)text.size()*6);
-    glDisableVertexAttribArray(program.positionAttribute);
-    glDisableVertexAttribArray(program.texCoordAttribute);
-}
-
-const std::vector<std::pair<float, float>> floatPairs(std::vector<glm::vec4> vertices)
-{
-    std::vector<std::pair<float, float>> pairs;
-    for(int pair = 0; pair < vertices.size(); pair++)
-    {
-        std::pair<float, float> temp = { vertices[pair].x, vertices[pair].y};
-        pairs.push_back(temp);
-    }
-    return pairs;
-}
@@ -882,7 +882,13 @@ static int      stbi__pnm_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
 // this is not threadsafe
+// images are decoded on several threads at once (see AssetManager), so each
+// keeps its own failure reason, as later stb_image releases also do
+#ifdef __cplusplus
+static thread_local const char *stbi__g_failure_reason;
+#else
 static const char *stbi__g_failure_reason;
+#endif
 
 STBIDEF const char *stbi_failure_reason(void)
 {
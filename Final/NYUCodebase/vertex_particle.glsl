@@ -0,0 +1,24 @@
+attribute vec2 velocity;
+attribute float age;
+
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+uniform vec2 origin;
+uniform float time;
+uniform float maxLifetime;
+uniform vec4 startColor;
+uniform vec4 endColor;
+
+varying vec4 colorVar;
+
+void main()
+{
+	// particles respawn at the origin every maxLifetime seconds, offset by their starting age
+	float lifetime = mod(age + time, maxLifetime);
+	vec4 position = vec4(origin + velocity * lifetime, 0.0, 1.0);
+	colorVar = mix(startColor, endColor, lifetime / maxLifetime);
+	vec4 p = viewMatrix * modelMatrix  * position;
+	gl_Position = projectionMatrix * p;
+}
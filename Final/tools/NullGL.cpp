@@ -0,0 +1,53 @@
+// The GL entry points ShaderProgram.cpp and ParticleEmitter.cpp call, doing
+// nothing, so tools can run the real emitter and snapshot code with no
+// context. Names come back as fresh nonzero numbers and every compile and
+// link reports success.
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <atomic>
+
+static std::atomic<GLuint> nextName(1);
+
+extern "C" {
+
+GLuint glCreateShader(GLenum) { return nextName++; }
+GLuint glCreateProgram() { return nextName++; }
+void glShaderSource(GLuint, GLsizei, const GLchar *const *, const GLint *) {}
+void glCompileShader(GLuint) {}
+void glAttachShader(GLuint, GLuint) {}
+void glLinkProgram(GLuint) {}
+void glGetShaderiv(GLuint, GLenum, GLint *params) { *params = GL_TRUE; }
+void glGetProgramiv(GLuint, GLenum, GLint *params) { *params = GL_TRUE; }
+void glGetShaderInfoLog(GLuint, GLsizei, GLsizei *length, GLchar *infoLog) {
+    if(length) {
+        *length = 0;
+    }
+    infoLog[0] = '\0';
+}
+void glDeleteShader(GLuint) {}
+void glDeleteProgram(GLuint) {}
+void glUseProgram(GLuint) {}
+
+GLint glGetAttribLocation(GLuint, const GLchar *) { return 0; }
+GLint glGetUniformLocation(GLuint, const GLchar *) { return 0; }
+void glUniform1f(GLint, GLfloat) {}
+void glUniform2f(GLint, GLfloat, GLfloat) {}
+void glUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) {}
+void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) {}
+
+void glGenBuffers(GLsizei n, GLuint *buffers) {
+    for(GLsizei i = 0; i < n; i++) {
+        buffers[i] = nextName++;
+    }
+}
+void glDeleteBuffers(GLsizei, const GLuint *) {}
+void glBindBuffer(GLenum, GLuint) {}
+void glBufferData(GLenum, GLsizeiptr, const void *, GLenum) {}
+void glBufferSubData(GLenum, GLintptr, GLsizeiptr, const void *) {}
+void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void *) {}
+void glEnableVertexAttribArray(GLuint) {}
+void glDisableVertexAttribArray(GLuint) {}
+void glDrawArrays(GLenum, GLint, GLsizei) {}
+
+}
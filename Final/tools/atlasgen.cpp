@@ -0,0 +1,84 @@
+// Writes a TextureAtlas XML out as a header of constexpr tables so release
+// builds can resolve sprite names at compile time without loading the XML.
+//
+//   c++ -std=c++11 -I../NYUCodebase atlasgen.cpp ../NYUCodebase/TextureAtlas.cpp -o atlasgen
+//   ./atlasgen ../NYUCodebase/sheet.xml 1024 1024 SheetAtlas > ../NYUCodebase/SheetAtlas.h
+
+#include "TextureAtlas.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static std::string floatLiteral(float value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", value);
+    std::string literal = buffer;
+    if(literal.find_first_of(".e") == std::string::npos) {
+        literal += ".0";
+    }
+    return literal + "f";
+}
+
+int main(int argc, char *argv[]) {
+    if(argc != 5) {
+        fprintf(stderr, "usage: %s atlas.xml imageWidth imageHeight Namespace\n", argv[0]);
+        return 1;
+    }
+    TextureAtlas atlas;
+    if(!atlas.Load(argv[1], (float)atof(argv[2]), (float)atof(argv[3]))) {
+        return 1;
+    }
+    const char *space = argv[4];
+    const char *source = strrchr(argv[1], '/');
+    source = source ? source + 1 : argv[1];
+
+    printf("// Generated by tools/atlasgen.cpp from %s (%sx%s). Do not edit.\n", source, argv[2], argv[3]);
+    printf("#pragma once\n\n#include \"TextureAtlas.h\"\n\n");
+    printf("namespace %s {\n", space);
+    printf("    constexpr int count = %d;\n", atlas.Count());
+    printf("    constexpr unsigned int bucketCount = %d;\n\n", (int)atlas.Displacements().size());
+
+    printf("    constexpr unsigned int displacements[] = {");
+    for(size_t i = 0; i < atlas.Displacements().size(); i++) {
+        printf("%s%u", (i % 16 == 0) ? "\n        " : " ", atlas.Displacements()[i]);
+        if(i + 1 < atlas.Displacements().size()) {
+            printf(",");
+        }
+    }
+    printf("\n    };\n\n");
+
+    printf("    constexpr int slots[] = {");
+    for(size_t i = 0; i < atlas.Slots().size(); i++) {
+        printf("%s%d", (i % 16 == 0) ? "\n        " : " ", atlas.Slots()[i]);
+        if(i + 1 < atlas.Slots().size()) {
+            printf(",");
+        }
+    }
+    printf("\n    };\n\n");
+
+    printf("    constexpr const char *names[] = {\n");
+    for(int i = 0; i < atlas.Count(); i++) {
+        printf("        \"%s\"%s\n", atlas.Name(i).c_str(), (i + 1 < atlas.Count()) ? "," : "");
+    }
+    printf("    };\n\n");
+
+    printf("    constexpr AtlasRegion regions[] = {\n");
+    for(int i = 0; i < atlas.Count(); i++) {
+        const AtlasRegion &region = atlas.Region(i);
+        printf("        {%s, %s, %s, %s}%s\n", floatLiteral(region.u).c_str(), floatLiteral(region.v).c_str(),
+               floatLiteral(region.width).c_str(), floatLiteral(region.height).c_str(), (i + 1 < atlas.Count()) ? "," : "");
+    }
+    printf("    };\n\n");
+
+    printf("    // Unknown names reach the throw, which is not a constant expression, so\n");
+    printf("    // a misspelt sprite fails to compile when used in a constant context.\n");
+    printf("    constexpr int checked(const char *name, int index) {\n");
+    printf("        return (index >= 0 && AtlasNameEquals(names[index], name)) ? index : throw \"unknown atlas region\";\n");
+    printf("    }\n\n");
+    printf("    constexpr int find(const char *name) {\n");
+    printf("        return checked(name, slots[AtlasHash(name, displacements[AtlasHash(name, 0u) %% bucketCount]) %% count]);\n");
+    printf("    }\n");
+    printf("}\n");
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Mixes the game's sound effects through AudioMixer with no sound card.
+//
+//   ./audiorender [effects.wav]
+//
+// Opens SDL_mixer on the dummy driver unless SDL_AUDIODRIVER names another,
+// so Mix_LoadWAV converts the samples to the device format, and registers the
+// sounds the way Play does. Then:
+//
+//   checks that SoundBank hands out one chunk per file and frees it with the
+//   last Release, and walks a VoiceManager through same-frame merging, the
+//   per-sound cap, stealing a voice and dropping a request;
+//
+//   offline, renders two seconds of a scripted game one step at a time with
+//   Render(), including one step that pushes more commands than the queue
+//   holds, writes the result to the WAV file and prints Stats();
+//
+//   live, opens the mixer on the device and pushes the same script at 60 Hz
+//   while the mixer thread and the device's post-mix hook run, and prints
+//   the underrun and queue counters.
+//
+// Exits with 2 if a check fails, the offline render did not mix every frame,
+// the burst was not counted as dropped, or the WAV could not be written.
+
+#include "AudioMixer.h"
+#include "SoundBank.h"
+#include <SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#define AUDIORENDER_SOUNDS "NYUCodebase/"
+#define AUDIORENDER_STEPS 120
+#define AUDIORENDER_VOICES 16
+
+struct ScriptSounds {
+    int shoot;
+    int hit;
+    int death;
+};
+
+// One simulation step's worth of commands, as Play::simulationLoop would push them.
+static void pushStep(AudioMixer &audio, const ScriptSounds &sounds, int step) {
+    if(step % 4 == 0) {
+        // both players fire on the same step; the second is merged
+        audio.Play(sounds.shoot);
+        audio.Play(sounds.shoot);
+    }
+    if(step % 7 == 0) {
+        audio.Play(sounds.hit);
+    }
+    if(step == 30) {
+        audio.Play(sounds.death);
+    }
+    if(step == 60) {
+        // a pile-up of collisions, more than the queue holds
+        for(int i = 0; i < AUDIO_COMMAND_CAPACITY + 64; i++) {
+            audio.Play(sounds.hit);
+        }
+    }
+    if(step == 90) {
+        audio.SetVolume(sounds.shoot, 0.5f);
+    }
+    if(step == 100) {
+        audio.StopSound(sounds.death);
+    }
+    audio.EndFrame();
+}
+
+static ScriptSounds registerSounds(AudioMixer &audio, Mix_Chunk *shoot, Mix_Chunk *hit, Mix_Chunk *death) {
+    ScriptSounds sounds;
+    sounds.shoot = audio.Register(shoot, 4, 0);
+    sounds.hit = audio.Register(hit, 2, 1);
+    sounds.death = audio.Register(death, 1, 2);
+    return sounds;
+}
+
+static bool check(bool condition, const char *what) {
+    if(!condition) {
+        printf("check failed: %s\n", what);
+    }
+    return condition;
+}
+
+static bool checkBank(SoundBank &bank) {
+    unsigned int decodes = bank.decodes;
+    int loaded = bank.LoadedCount();
+    Mix_Chunk *first = bank.Acquire(AUDIORENDER_SOUNDS "hit1.wav");
+    Mix_Chunk *second = bank.Acquire(AUDIORENDER_SOUNDS "hit1.wav");
+    bool passed = check(first && first == second, "a file acquired twice gives the same chunk");
+    passed &= check(bank.decodes == decodes + 1, "a file acquired twice is decoded once");
+    bank.Release(first);
+    passed &= check(bank.LoadedCount() == loaded + 1, "a chunk stays loaded while referenced");
+    bank.Release(second);
+    passed &= check(bank.LoadedCount() == loaded, "the last Release frees the chunk");
+    return passed;
+}
+
+// Voices only finish when mixed past the end of their chunk, so until the
+// final Mix every voice started stays busy.
+static bool checkVoices(Mix_Chunk *shoot, Mix_Chunk *hit, Mix_Chunk *death, int channels) {
+    VoiceManager voices;
+    voices.Open(8);
+    int shootSound = voices.Register(shoot, 4, 0);
+    int hitSound = voices.Register(hit, 2, 1);
+    int deathSound = voices.Register(death, 1, 2);
+    bool passed = check(voices.Play(shootSound) >= 0, "a sound starts on a free voice");
+    passed &= check(voices.Play(shootSound) < 0 && voices.stats.merged == 1, "a repeat in the same frame is merged");
+    voices.EndFrame();
+    for(int i = 0; i < 4; i++) {
+        voices.Play(shootSound);
+        voices.EndFrame();
+    }
+    passed &= check(voices.BusyCount() == 4 && voices.stats.capped == 1, "a fifth shot restarts the oldest of four");
+    voices.Play(hitSound);
+    voices.EndFrame();
+    voices.Play(hitSound);
+    voices.EndFrame();
+    voices.Play(deathSound);
+    voices.EndFrame();
+    voices.Play(hitSound);
+    voices.EndFrame();
+    passed &= check(voices.BusyCount() == 7 && voices.stats.capped == 2, "a third hit restarts the oldest of two");
+
+    // every voice busy with deaths: a shot is dropped, another death takes the oldest voice
+    VoiceManager full;
+    full.Open(2);
+    int firstDeath = full.Register(death, 2, 2);
+    int secondDeath = full.Register(death, 2, 2);
+    int fullShoot = full.Register(shoot, 4, 0);
+    full.Play(firstDeath);
+    full.Play(secondDeath);
+    full.EndFrame();
+    passed &= check(full.Play(fullShoot) < 0 && full.stats.dropped == 1, "a shot with every voice on a death is dropped");
+    passed &= check(full.Play(firstDeath) == 0 && full.stats.stolen == 1, "a death steals the oldest voice of its priority");
+
+    Uint32 longest = shoot->alen > hit->alen ? shoot->alen : hit->alen;
+    longest = longest > death->alen ? longest : death->alen;
+    int frames = (int)(longest / (channels * sizeof(Sint16))) + 1;
+    std::vector<int> mix(frames * channels);
+    voices.Mix(mix.data(), frames, channels);
+    passed &= check(voices.BusyCount() == 0, "voices free up once mixed to the end");
+    printf("voices: %u played, %u merged, %u capped; full manager %u stolen, %u dropped\n", voices.stats.played, voices.stats.merged,
+           voices.stats.capped, full.stats.stolen, full.stats.dropped);
+    return passed;
+}
+
+static void printStats(const char *name, const AudioMixer &audio) {
+    AudioStats stats = audio.Stats();
+    const VoiceStats &voices = audio.VoiceCounts();
+    printf("%s: %u frames mixed, %u underruns; queue %d waiting, high water %d of %d, %u dropped full\n", name, stats.mixedFrames,
+           stats.underruns, stats.queueDepth, stats.queueHighWater, AUDIO_COMMAND_CAPACITY, stats.queueFull);
+    printf("%s voices: %u played, %u merged, %u capped, %u stolen, %u dropped\n", name, voices.played, voices.merged, voices.capped,
+           voices.stolen, voices.dropped);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fileName = argc > 1 ? argv[1] : "effects.wav";
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    if(SDL_Init(SDL_INIT_AUDIO) != 0) {
+        fprintf(stderr, "Unable to start SDL audio: %s\n", SDL_GetError());
+        return 1;
+    }
+    if(Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) != 0) {
+        fprintf(stderr, "Unable to open audio: %s\n", Mix_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    int frequency;
+    Uint16 format;
+    int channels;
+    Mix_QuerySpec(&frequency, &format, &channels);
+    int stepFrames = frequency / 60;
+
+    SoundBank bank;
+    Mix_Chunk *shoot = bank.Acquire(AUDIORENDER_SOUNDS "shoot2.wav");
+    Mix_Chunk *hit = bank.Acquire(AUDIORENDER_SOUNDS "hit.wav");
+    Mix_Chunk *death = bank.Acquire(AUDIORENDER_SOUNDS "death.wav");
+    if(!shoot || !hit || !death) {
+        Mix_CloseAudio();
+        SDL_Quit();
+        return 1;
+    }
+
+    bool passed = checkBank(bank);
+    passed &= checkVoices(shoot, hit, death, channels);
+    {
+        AudioMixer audio(AUDIORENDER_VOICES);
+        ScriptSounds sounds = registerSounds(audio, shoot, hit, death);
+        std::vector<Sint16> samples(AUDIORENDER_STEPS * stepFrames * channels);
+        for(int step = 0; step < AUDIORENDER_STEPS; step++) {
+            pushStep(audio, sounds, step);
+            audio.Render(&samples[step * stepFrames * channels], stepFrames, channels);
+        }
+        printStats("offline", audio);
+        AudioStats stats = audio.Stats();
+        if(stats.mixedFrames != (unsigned int)(AUDIORENDER_STEPS * stepFrames) || stats.queueFull == 0) {
+            passed = false;
+        }
+        if(AudioMixer::WriteWAV(fileName, samples, frequency, channels)) {
+            printf("wrote %d frames at %d Hz to %s\n", AUDIORENDER_STEPS * stepFrames, frequency, fileName);
+        } else {
+            passed = false;
+        }
+    }
+    {
+        AudioMixer audio(AUDIORENDER_VOICES);
+        ScriptSounds sounds = registerSounds(audio, shoot, hit, death);
+        if(audio.Open()) {
+            std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+            for(int step = 0; step < AUDIORENDER_STEPS; step++) {
+                pushStep(audio, sounds, step);
+                next += std::chrono::microseconds(16667);
+                std::this_thread::sleep_until(next);
+            }
+            audio.Close();
+            printStats("live", audio);
+        }
+    }
+
+    bank.Clear();
+    Mix_CloseAudio();
+    SDL_Quit();
+    if(!passed) {
+        printf("FAILED\n");
+        return 2;
+    }
+    return 0;
+}
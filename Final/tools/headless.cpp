@@ -0,0 +1,109 @@
+// Runs the simulation with no window, GPU or audio, for CI machines.
+//
+//   ./headless --replay session.rpl
+//
+// Re-simulates a file written by the game's --record flag and exits with 2 if
+// any state hash disagrees, exactly like the game's own --replay.
+//
+//   ./headless --stress 2000 [--frames 600]
+//
+// Two players shooting and turning among N small asteroids scattered over the
+// whole screen, kept at N by spawning more after every step. The game's own
+// spawner puts every asteroid in a corner at up to a screen-height across,
+// which at these counts would make every body touch every other. The players
+// are healed between steps so a lost game never clears the field. Prints the
+// time per step and exits with 3 if the average does not fit in one 60 Hz
+// frame. --stress 500 is the load the world-space hull cache is judged at.
+
+#include "Replay.h"
+#include "SheetAtlas.h"
+#include "Simulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define STRESS_TIMESTEP 0.0166666f
+
+static SpriteExtents extentsOf(const char *name) {
+    return SpriteExtents::FromRegion(SheetAtlas::regions[SheetAtlas::find(name)], 0.1f);
+}
+
+static void spawnStressAsteroid(Simulation &sim, Random &random) {
+    int shape = (int)random.Range(0, 3.9f);
+    float sizeX = random.Range(0.02f, 0.08f);
+    float sizeY = random.Range(0.02f, 0.08f);
+    float rotation = random.Range(0, 360);
+    float positionX = random.Range(-1.77f, 1.77f);
+    float positionY = random.Range(-1.0f, 1.0f);
+    float velocityX = random.Range(-0.75f, 0.55f);
+    float velocityY = random.Range(-0.55f, 0.75f);
+    sim.asteroids.Acquire(Asteroid(glm::vec3(positionX, positionY, 0.0f), glm::vec3(sizeX, sizeY, 0.5f), rotation,
+                                   glm::vec3(velocityX, velocityY, 0.0f), sim.possibleIndices[shape], sim.possibleAxes[shape]));
+}
+
+static int runStress(int bodies, int frames) {
+    if(bodies > MAX_ASTEROIDS) {
+        fprintf(stderr, "at most %d asteroids\n", MAX_ASTEROIDS);
+        return 1;
+    }
+    Simulation sim(extentsOf("playerShip2_red.png"), extentsOf("playerShip2_blue.png"), extentsOf("laserRed03.png"), 1);
+    sim.player2Enable();
+    Random random(7);
+    unsigned int inputBits = INPUT_SHOOT | INPUT_ROTATE_LEFT;
+    inputBits |= (INPUT_SHOOT | INPUT_FORWARD) << INPUT_PLAYER_BITS;
+    double total = 0.0;
+    double worst = 0.0;
+    for(int i = 0; i < frames; i++) {
+        // Outside the timed step. At these densities a ship can be hit
+        // several times in one step, hence more health than the game gives.
+        sim.player1.health = 100;
+        sim.player2.health = 100;
+        while((int)sim.asteroids.Size() < bodies) {
+            spawnStressAsteroid(sim, random);
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sim.Step(inputBits, STRESS_TIMESTEP);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        total += ms;
+        if(ms > worst) {
+            worst = ms;
+        }
+        sim.events.clear();
+    }
+    double average = total / frames;
+    printf("%d asteroids, %d steps: %.3f ms/step average, %.3f ms worst, budget %.1f ms\n", bodies, frames, average, worst,
+           STRESS_TIMESTEP * 1000.0f);
+    PrintNarrowphaseStats(sim.narrowphaseStats);
+    return average <= STRESS_TIMESTEP * 1000.0f ? 0 : 3;
+}
+
+int main(int argc, char *argv[]) {
+    std::string replayPath;
+    int stressBodies = 0;
+    int stressFrames = 600;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if(strcmp(argv[i], "--stress") == 0 && i + 1 < argc) {
+            stressBodies = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            stressFrames = atoi(argv[++i]);
+        }
+    }
+    if(stressBodies > 0 && stressFrames > 0) {
+        return runStress(stressBodies, stressFrames);
+    }
+    if(replayPath.empty()) {
+        fprintf(stderr, "usage: %s --replay file\n       %s --stress asteroids [--frames steps]\n", argv[0], argv[0]);
+        return 1;
+    }
+    ReplayPlayer replay;
+    if(!replay.Load(replayPath)) {
+        return 1;
+    }
+    ReplayResult result = replay.Run();
+    PrintReplayResult(result);
+    return result.mismatches == 0 ? 0 : 2;
+}
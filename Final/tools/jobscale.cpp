@@ -0,0 +1,75 @@
+// How the simulation step scales with job system workers.
+//
+//   ./jobscale [steps]
+//
+// Steps the same 900-asteroid, two-player game with Simulation::jobs unset,
+// then with 0, 1, 3 and 7 workers (1, 2, 4 and 8 threads), and prints the
+// time per step of each. Every step's StateHash must match the run without
+// jobs, since threading must never change the outcome; exits with 2 if any
+// differs.
+
+#include "JobSystem.h"
+#include "SheetAtlas.h"
+#include "Simulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define JOBSCALE_ASTEROIDS 900
+#define JOBSCALE_TIMESTEP 0.0166666f
+
+static SpriteExtents extentsOf(const char *name) {
+    return SpriteExtents::FromRegion(SheetAtlas::regions[SheetAtlas::find(name)], 0.1f);
+}
+
+// Runs the game from the same start every time; hashes gets one entry per step.
+static double run(JobSystem *jobs, int steps, std::vector<unsigned int> &hashes) {
+    Simulation sim(extentsOf("playerShip2_red.png"), extentsOf("playerShip2_blue.png"), extentsOf("laserRed03.png"), 11);
+    sim.player2Enable();
+    for(int i = 0; i < JOBSCALE_ASTEROIDS; i++) {
+        sim.asteroidCreation();
+    }
+    sim.jobs = jobs;
+    hashes.clear();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int step = 0; step < steps; step++) {
+        unsigned int inputBits = (step % 5 == 0) ? INPUT_SHOOT : INPUT_ROTATE_LEFT;
+        sim.Step(inputBits | (INPUT_SHOOT | INPUT_FORWARD) << INPUT_PLAYER_BITS, JOBSCALE_TIMESTEP);
+        sim.events.clear();
+        hashes.push_back(sim.StateHash());
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / steps;
+}
+
+int main(int argc, char *argv[]) {
+    int steps = argc > 1 ? atoi(argv[1]) : 300;
+    if(steps <= 0) {
+        fprintf(stderr, "usage: %s [steps]\n", argv[0]);
+        return 1;
+    }
+    std::vector<unsigned int> serialHashes;
+    double serial = run(nullptr, steps, serialHashes);
+    printf("%d asteroids, %d steps\nno jobs:   %.3f ms/step\n", JOBSCALE_ASTEROIDS, steps, serial);
+
+    const int workerCounts[] = {0, 1, 3, 7};
+    bool matched = true;
+    std::vector<unsigned int> hashes;
+    for(int workers : workerCounts) {
+        JobSystem jobs(workers);
+        double ms = run(&jobs, steps, hashes);
+        int mismatches = 0;
+        for(int step = 0; step < steps; step++) {
+            if(hashes[step] != serialHashes[step]) {
+                mismatches++;
+            }
+        }
+        JobStats stats = jobs.Stats();
+        printf("%d workers: %.3f ms/step (%.2fx), %d jobs, %d stolen, %d/%d hashes differ\n", workers, ms, serial / ms, stats.jobs,
+               stats.steals, mismatches, steps);
+        if(mismatches) {
+            matched = false;
+        }
+    }
+    return matched ? 0 : 2;
+}
@@ -0,0 +1,134 @@
+// Particle update before and after the move to structure-of-arrays.
+//
+//   ./particlebench [particles] [updates]
+//
+// Times the array-of-structs loop ParticleEmitter::Update ran before, kept
+// here as it was, against UpdateParticlesScalar and the SSE/AVX
+// UpdateParticles on the same 100k particles, and checks that all three end
+// with the same positions.
+
+#include "ParticleEmitter.h"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define PARTICLEBENCH_TIMESTEP 0.0166666f
+#define PARTICLEBENCH_LIFETIME 3.0f
+
+// the old per-particle layout: 72 bytes, of which the update touches 20
+class Particle
+{
+public:
+    Particle(glm::vec3 position, glm::vec3 velocity, float lifetime, glm::vec4 sColor, glm::vec4 eColor)
+    : position(position), velocity(velocity), lifetime(lifetime), startColor(sColor), endColor(eColor)
+    {
+        position.x += velocity.x * lifetime * 2;
+        position.y += velocity.y * lifetime * 2;
+    }
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 velocityDeviation;
+    float lifetime;
+
+    glm::vec4 startColor;
+    glm::vec4 endColor;
+};
+
+static void updateArrayOfStructs(std::vector<Particle>& particles, glm::vec3 position, float maxLifetime, float elapsed)
+{
+    for(Particle& part : particles)
+    {
+        if(part.lifetime > maxLifetime)
+        {
+            part.lifetime = 0.0f;
+            part.position.x = position.x;
+            part.position.y = position.y;
+        }
+        part.position.x += part.velocity.x * elapsed;
+        part.position.y += part.velocity.y * elapsed;
+        part.lifetime += elapsed;
+    }
+}
+
+struct ParticleArrays {
+    explicit ParticleArrays(unsigned int size) : x(size), y(size), vx(size), vy(size), life(size) {}
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> life;
+};
+
+static float randomRange(float low, float high) {
+    return low + (high - low) * (rand() / (float)RAND_MAX);
+}
+
+template <typename Update>
+static double timeUpdates(int updates, Update update) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < updates; i++) {
+        update();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / updates;
+}
+
+static float largestDifference(const std::vector<Particle> &particles, const ParticleArrays &arrays) {
+    float largest = 0.0f;
+    for(size_t i = 0; i < particles.size(); i++) {
+        largest = fmaxf(largest, fabsf(particles[i].position.x - arrays.x[i]));
+        largest = fmaxf(largest, fabsf(particles[i].position.y - arrays.y[i]));
+    }
+    return largest;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int updates = argc > 2 ? atoi(argv[2]) : 1000;
+    if(count <= 0 || updates <= 0) {
+        fprintf(stderr, "usage: %s [particles] [updates]\n", argv[0]);
+        return 1;
+    }
+    // the kernels take whole lanes, as ParticleEmitter pads to
+    unsigned int size = (count + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+    glm::vec3 origin(0.25f, -0.5f, 0.0f);
+
+    std::vector<Particle> particles;
+    ParticleArrays scalar(size);
+    srand(3);
+    for(unsigned int i = 0; i < size; i++) {
+        glm::vec3 velocity(randomRange(-1, 1), randomRange(-1, 1), 0.0f);
+        float lifetime = randomRange(0, PARTICLEBENCH_LIFETIME);
+        particles.push_back(Particle(origin, velocity, lifetime, glm::vec4(1.0f), glm::vec4(0.0f)));
+        scalar.x[i] = particles[i].position.x;
+        scalar.y[i] = particles[i].position.y;
+        scalar.vx[i] = velocity.x;
+        scalar.vy[i] = velocity.y;
+        scalar.life[i] = lifetime;
+    }
+    ParticleArrays simd = scalar;
+
+    double arrayOfStructs = timeUpdates(updates, [&]() {
+        updateArrayOfStructs(particles, origin, PARTICLEBENCH_LIFETIME, PARTICLEBENCH_TIMESTEP);
+    });
+    double structOfArrays = timeUpdates(updates, [&]() {
+        UpdateParticlesScalar(scalar.x.data(), scalar.y.data(), scalar.vx.data(), scalar.vy.data(), scalar.life.data(), size,
+                              origin.x, origin.y, PARTICLEBENCH_LIFETIME, PARTICLEBENCH_TIMESTEP);
+    });
+    double vectorized = timeUpdates(updates, [&]() {
+        UpdateParticles(simd.x.data(), simd.y.data(), simd.vx.data(), simd.vy.data(), simd.life.data(), size,
+                        origin.x, origin.y, PARTICLEBENCH_LIFETIME, PARTICLEBENCH_TIMESTEP);
+    });
+
+    printf("%u particles, %d updates\n", size, updates);
+    printf("array of structs:       %.3f ms/update\n", arrayOfStructs);
+    printf("struct of arrays:       %.3f ms/update (%.2fx)\n", structOfArrays, arrayOfStructs / structOfArrays);
+    printf("struct of arrays, SIMD: %.3f ms/update (%.2fx)\n", vectorized, arrayOfStructs / vectorized);
+    float scalarDifference = largestDifference(particles, scalar);
+    float simdDifference = largestDifference(particles, simd);
+    printf("largest position difference from array of structs: %g scalar, %g SIMD\n", scalarDifference, simdDifference);
+    return scalarDifference < 1e-4f && simdDifference < 1e-4f ? 0 : 2;
+}
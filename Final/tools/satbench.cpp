@@ -0,0 +1,132 @@
+// Separating axis tests per second, deriving the axes on every test versus
+// using each hull's cached axes.
+//
+//   ./satbench [pairs] [rounds]
+//
+// Builds random pairs of the game's asteroid outlines, each scaled and rotated
+// the way Asteroid does, near enough to each other that about half overlap.
+// Times CheckSATCollision(first, second), which takes an edge normal from
+// every edge of both hulls each call, against the overload given the axes
+// BuildHullAxes, ScaleHullAxes and RotateHullAxes keep per hull, with parallel
+// edges sharing one axis. Exits with 2 if the two ever disagree.
+
+#include "Collision.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// one side of a pair, in world space
+struct BenchHull {
+    std::vector<float> points;
+    std::vector<float> axes;
+};
+
+struct BenchPair {
+    BenchHull first;
+    BenchHull second;
+};
+
+static float randomRange(float low, float high) {
+    return low + (high - low) * (rand() / (float)RAND_MAX);
+}
+
+static void buildHull(const std::vector<float> &outline, const std::vector<float> &outlineAxes, float offsetX, float offsetY, BenchHull &hull) {
+    float scaleX = randomRange(0.1f, 0.6f);
+    float scaleY = randomRange(0.1f, 1.0f);
+    float angle = randomRange(0.0f, 6.2831853f);
+    std::vector<float> scaled;
+    int axisCount = ScaleHullAxes(outlineAxes.data(), (int)outlineAxes.size() / 2, scaleX, scaleY, scaled);
+    hull.axes.resize(axisCount * 2);
+    RotateHullAxes(scaled.data(), axisCount, angle, hull.axes.data());
+    float c = cosf(angle);
+    float s = sinf(angle);
+    for(size_t i = 0; i < outline.size(); i += 2) {
+        float x = outline[i] * scaleX;
+        float y = outline[i + 1] * scaleY;
+        hull.points.push_back(x * c - y * s + offsetX);
+        hull.points.push_back(x * s + y * c + offsetY);
+    }
+}
+
+static HullSpan hullOf(const BenchHull &hull) {
+    return HullSpan(hull.points.data(), (int)hull.points.size() / 2);
+}
+
+static AxisSpan axesOf(const BenchHull &hull) {
+    return AxisSpan(hull.axes.data(), (int)hull.axes.size() / 2);
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 4096;
+    int rounds = argc > 2 ? atoi(argv[2]) : 500;
+    if(count <= 0 || rounds <= 0) {
+        fprintf(stderr, "usage: %s [pairs] [rounds]\n", argv[0]);
+        return 1;
+    }
+    // the game's asteroid outlines, as listed in Simulation's constructor
+    std::vector<std::vector<float>> outlines;
+    outlines.push_back({ -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f });
+    outlines.push_back({ -0.4f, -0.4f, 0.4f, -0.4f, 0.6f, 0.0f, 0.5f, 0.5f, -0.6f, 0.0f });
+    outlines.push_back({ -0.5f, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f });
+    outlines.push_back({ -0.4f, -0.4f, 0.4f, -0.4f, 0.8f, 0.0f, 0.4f, 0.4f, -0.4f, 0.4f, -0.8f, 0.0f });
+    std::vector<std::vector<float>> outlineAxes(outlines.size());
+    int edges = 0;
+    int axes = 0;
+    for(size_t i = 0; i < outlines.size(); i++) {
+        edges += (int)outlines[i].size() / 2;
+        axes += BuildHullAxes(outlines[i].data(), (int)outlines[i].size() / 2, outlineAxes[i]);
+    }
+    printf("outlines: %d edges, %d distinct axes\n", edges, axes);
+
+    srand(1);
+    std::vector<BenchPair> pairs(count);
+    for(BenchPair &pair : pairs) {
+        int first = rand() % outlines.size();
+        int second = rand() % outlines.size();
+        buildHull(outlines[first], outlineAxes[first], 0.0f, 0.0f, pair.first);
+        buildHull(outlines[second], outlineAxes[second], randomRange(-0.6f, 0.6f), randomRange(-0.6f, 0.6f), pair.second);
+    }
+
+    int hits = 0;
+    int mismatches = 0;
+    float largestDifference = 0.0f;
+    for(const BenchPair &pair : pairs) {
+        std::pair<float, float> derived;
+        std::pair<float, float> cached;
+        bool derivedHit = CheckSATCollision(hullOf(pair.first), hullOf(pair.second), derived);
+        bool cachedHit = CheckSATCollision(hullOf(pair.first), axesOf(pair.first), hullOf(pair.second), axesOf(pair.second), cached);
+        if(derivedHit != cachedHit) {
+            mismatches++;
+        } else if(derivedHit) {
+            hits++;
+            largestDifference = fmaxf(largestDifference, fabsf(derived.first - cached.first) + fabsf(derived.second - cached.second));
+        }
+    }
+
+    volatile int sink = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++) {
+        for(const BenchPair &pair : pairs) {
+            std::pair<float, float> penetration;
+            sink += CheckSATCollision(hullOf(pair.first), hullOf(pair.second), penetration);
+        }
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++) {
+        for(const BenchPair &pair : pairs) {
+            std::pair<float, float> penetration;
+            sink += CheckSATCollision(hullOf(pair.first), axesOf(pair.first), hullOf(pair.second), axesOf(pair.second), penetration);
+        }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double tests = (double)count * rounds;
+    double derivedRate = tests / std::chrono::duration<double>(middle - start).count() / 1e6;
+    double cachedRate = tests / std::chrono::duration<double>(end - middle).count() / 1e6;
+
+    printf("%d pairs, %d overlapping, %d disagree, largest penetration difference %g\n", count, hits, mismatches, largestDifference);
+    printf("axes from edges: %.2f M tests/s\n", derivedRate);
+    printf("cached axes:     %.2f M tests/s (%.2fx)\n", cachedRate, cachedRate / derivedRate);
+    return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,166 @@
+// Runs the game's simulation thread hand-off with no window: one thread steps
+// a Simulation at 1000 Hz and publishes RenderSnapshots through a
+// TripleBuffer, exactly as Play::simulationLoop does, while this thread takes
+// the newest one and reads and draws every field, as the render loop does.
+// Built with -fsanitize=thread by `make check`, so a data race fails it too.
+//
+// Every published frame carries its step number and a checksum of its
+// contents taken right after capture. The consumer fails on
+//   a torn frame, whose contents no longer match the checksum, and
+//   a stale frame, one that is not newer than the last frame it took,
+// and finally checks that the last step published is the one it ends on.
+
+#include "RenderSnapshot.h"
+#include "SheetAtlas.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#define SIMTHREAD_STEPS 2000
+#define SIMTHREAD_TIMESTEP 0.001f
+
+struct StampedSnapshot {
+    StampedSnapshot() : step(-1), checksum(0) {}
+    RenderSnapshot snapshot;
+    int step;
+    unsigned int checksum;
+};
+
+// 32-bit FNV-1a
+static void hashBytes(unsigned int &hash, const void *data, size_t length) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for(size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+}
+
+template <typename T>
+static void hashVector(unsigned int &hash, const std::vector<T> &values) {
+    size_t size = values.size();
+    hashBytes(hash, &size, sizeof(size));
+    if(size) {
+        hashBytes(hash, values.data(), size * sizeof(T));
+    }
+}
+
+static void hashTransform(unsigned int &hash, const SnapshotTransform &transform) {
+    hashBytes(hash, &transform.previousPosition, sizeof(transform.previousPosition));
+    hashBytes(hash, &transform.position, sizeof(transform.position));
+    hashBytes(hash, &transform.previousRotation, sizeof(transform.previousRotation));
+    hashBytes(hash, &transform.rotation, sizeof(transform.rotation));
+}
+
+static unsigned int checksumOf(const StampedSnapshot &frame) {
+    const RenderSnapshot &snapshot = frame.snapshot;
+    unsigned int hash = 2166136261u;
+    hashBytes(hash, &frame.step, sizeof(frame.step));
+    hashTransform(hash, snapshot.player1);
+    hashTransform(hash, snapshot.player2);
+    hashBytes(hash, &snapshot.player1Health, sizeof(snapshot.player1Health));
+    hashBytes(hash, &snapshot.player2Health, sizeof(snapshot.player2Health));
+    hashBytes(hash, snapshot.player1ScoreText.data(), snapshot.player1ScoreText.size());
+    hashBytes(hash, snapshot.player2ScoreText.data(), snapshot.player2ScoreText.size());
+    for(const SnapshotTransform &bullet : snapshot.bullets) {
+        hashTransform(hash, bullet);
+    }
+    for(const AsteroidSnapshot &asteroid : snapshot.asteroids) {
+        hashTransform(hash, asteroid.transform);
+        hashBytes(hash, &asteroid.firstPoint, sizeof(asteroid.firstPoint));
+        hashBytes(hash, &asteroid.pointCount, sizeof(asteroid.pointCount));
+    }
+    hashVector(hash, snapshot.outlines);
+    hashVector(hash, snapshot.background.x);
+    hashVector(hash, snapshot.background.y);
+    unsigned int collisions = snapshot.collisions.ActiveCount();
+    hashBytes(hash, &collisions, sizeof(collisions));
+    return hash;
+}
+
+static SpriteExtents extentsOf(const char *name) {
+    return SpriteExtents::FromRegion(SheetAtlas::regions[SheetAtlas::find(name)], 0.1f);
+}
+
+int main() {
+    Simulation sim(extentsOf("playerShip2_red.png"), extentsOf("playerShip2_blue.png"), extentsOf("laserRed03.png"), 7);
+    sim.player2Enable();
+    ParticleEmitter background(glm::vec3(0.0f), 3.0f, 200);
+    EmitterPool collisions(16, 0.5f, 0.5f, 40, glm::vec4(1.0f), glm::vec4(0.0f));
+    TripleBuffer<StampedSnapshot> snapshots;
+    std::atomic<bool> running(true);
+
+    std::thread simulation([&]() {
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+        for(int step = 0; step < SIMTHREAD_STEPS; step++) {
+            unsigned int inputBits = (step % 7 == 0) ? INPUT_SHOOT : INPUT_FORWARD | INPUT_ROTATE_LEFT;
+            sim.Step(inputBits | (INPUT_SHOOT | INPUT_ROTATE_LEFT) << INPUT_PLAYER_BITS, SIMTHREAD_TIMESTEP);
+            for(const SimulationEvent &event : sim.events) {
+                if(event.type == ASTEROIDS_COLLIDED) {
+                    collisions.Emit(event.position);
+                }
+            }
+            sim.events.clear();
+            background.Update(SIMTHREAD_TIMESTEP);
+            collisions.Update(SIMTHREAD_TIMESTEP);
+
+            StampedSnapshot &frame = snapshots.Back();
+            frame.snapshot.Capture(sim);
+            frame.snapshot.timestep = SIMTHREAD_TIMESTEP;
+            frame.snapshot.background = background;
+            frame.snapshot.collisions = collisions;
+            frame.step = step;
+            frame.checksum = checksumOf(frame);
+            snapshots.Publish();
+
+            next += std::chrono::microseconds(1000);
+            std::this_thread::sleep_until(next);
+        }
+        running = false;
+    });
+
+    ShaderProgram program;
+    int frames = 0;
+    int torn = 0;
+    int stale = 0;
+    int lastStep = -1;
+    float sum = 0.0f;
+    while(running) {
+        if(!snapshots.Acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+        StampedSnapshot &frame = snapshots.Front();
+        frames++;
+        if(frame.step <= lastStep) {
+            stale++;
+        }
+        lastStep = frame.step;
+        // what the render loop reads, in the order it reads it
+        const RenderSnapshot &snapshot = frame.snapshot;
+        sum += snapshot.player1.Matrix(0.5f)[3][0] + snapshot.player2.Matrix(0.5f)[3][0];
+        for(const SnapshotTransform &bullet : snapshot.bullets) {
+            sum += bullet.Matrix(0.5f)[3][1];
+        }
+        for(const AsteroidSnapshot &asteroid : snapshot.asteroids) {
+            sum += asteroid.transform.Matrix(0.5f)[3][0] + snapshot.outlines[(asteroid.firstPoint + asteroid.pointCount) * 2 - 1];
+        }
+        frame.snapshot.background.Render(program, 0.5f);
+        frame.snapshot.collisions.Render(program, 0.5f);
+        if(checksumOf(frame) != frame.checksum) {
+            torn++;
+        }
+    }
+    simulation.join();
+    if(snapshots.Acquire()) {
+        lastStep = snapshots.Front().step;
+    }
+
+    printf("%d steps, %d frames taken, %d torn, %d stale, last step %d (checksum %g)\n", SIMTHREAD_STEPS, frames, torn, stale, lastStep, sum);
+    if(frames == 0 || torn || stale || lastStep != SIMTHREAD_STEPS - 1) {
+        printf("FAILED\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "AssetManager.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static bool readFile(const std::string &fileName, std::string &contents) {
+    std::ifstream infile(fileName.c_str(), std::ios::binary);
+    if(infile.fail()) {
+        std::cout << "Error opening shader file:" << fileName << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << infile.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+AssetManager::AssetManager(int workers, const std::string &textureCacheDirectory) : textures(textureCacheDirectory), running(true), decoded(0), ready(0), failed(0) {
+    if(workers < 1) {
+        workers = 1;
+    }
+    for(int i = 0; i < workers; i++) {
+        threads.push_back(std::thread(&AssetManager::WorkerLoop, this));
+    }
+}
+
+AssetManager::~AssetManager() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+    }
+    decodeReady.notify_all();
+    uploadSpace.notify_all();
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    for(std::unique_ptr<Asset> &asset : assets) {
+        TextureCache::Release(asset->image);
+    }
+}
+
+AssetHandle AssetManager::Queue(Asset *asset) {
+    assets.push_back(std::unique_ptr<Asset>(asset));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        decodeQueue.push_back(asset);
+    }
+    decodeReady.notify_one();
+    return (AssetHandle)assets.size() - 1;
+}
+
+AssetHandle AssetManager::Load(const std::function<bool()> &decode, const std::function<bool()> &upload) {
+    Asset *asset = new Asset();
+    asset->decode = decode;
+    asset->upload = upload;
+    return Queue(asset);
+}
+
+AssetHandle AssetManager::LoadTexture(const std::string &fileName, bool nearest) {
+    Asset *asset = new Asset();
+    asset->fileName = fileName;
+    asset->nearest = nearest;
+    asset->decode = [this, asset]() -> bool { return DecodeTexture(*asset); };
+    asset->upload = [this, asset]() -> bool { return UploadTexture(*asset); };
+    return Queue(asset);
+}
+
+AssetHandle AssetManager::LoadShader(const std::string &vertexFile, const std::string &fragmentFile,
+                                     const std::function<bool(const std::string &, const std::string &)> &link) {
+    Asset *asset = new Asset();
+    asset->decode = [asset, vertexFile, fragmentFile]() -> bool {
+        return readFile(vertexFile, asset->sources[0]) && readFile(fragmentFile, asset->sources[1]);
+    };
+    asset->upload = [asset, link]() -> bool {
+        bool linked = link(asset->sources[0], asset->sources[1]);
+        asset->sources[0].clear();
+        asset->sources[1].clear();
+        return linked;
+    };
+    return Queue(asset);
+}
+
+bool AssetManager::DecodeTexture(Asset &asset) {
+    return textures.Load(asset.fileName, asset.nearest, asset.image);
+}
+
+bool AssetManager::UploadTexture(Asset &asset) {
+    glGenTextures(1, &asset.texture);
+    glBindTexture(GL_TEXTURE_2D, asset.texture);
+    TextureCache::Upload(asset.image);
+    GLint filter = asset.nearest ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    TextureCache::Release(asset.image);
+    return true;
+}
+
+void AssetManager::Finished(Asset &asset, bool success) {
+    asset.state = success ? ASSET_READY : ASSET_FAILED;
+    if(success) {
+        ready++;
+    } else {
+        failed++;
+    }
+}
+
+void AssetManager::WorkerLoop() {
+    while(true) {
+        Asset *asset;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            decodeReady.wait(guard, [this] { return !running || !decodeQueue.empty(); });
+            if(!running) {
+                return;
+            }
+            asset = decodeQueue.front();
+            decodeQueue.pop_front();
+        }
+        bool success = asset->decode();
+        decoded++;
+        if(!success || !asset->upload) {
+            Finished(*asset, success);
+            std::lock_guard<std::mutex> guard(lock);
+            // wakes Wait() and Finish(), which sleep on the upload queue
+            uploadReady.notify_all();
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            uploadSpace.wait(guard, [this] { return !running || uploadQueue.size() < ASSET_UPLOAD_QUEUE; });
+            if(!running) {
+                return;
+            }
+            asset->state = ASSET_UPLOAD_QUEUED;
+            uploadQueue.push_back(asset);
+        }
+        uploadReady.notify_all();
+    }
+}
+
+int AssetManager::Update(float budget) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int uploaded = 0;
+    while(true) {
+        Asset *asset;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if(uploadQueue.empty()) {
+                break;
+            }
+            asset = uploadQueue.front();
+            uploadQueue.pop_front();
+        }
+        uploadSpace.notify_one();
+        Finished(*asset, asset->upload());
+        uploaded++;
+        if(std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= budget) {
+            break;
+        }
+    }
+    return uploaded;
+}
+
+void AssetManager::Wait(AssetHandle handle) {
+    while(State(handle) != ASSET_READY && State(handle) != ASSET_FAILED) {
+        if(Update(1.0f) == 0) {
+            std::unique_lock<std::mutex> guard(lock);
+            uploadReady.wait_for(guard, std::chrono::milliseconds(1), [this] { return !uploadQueue.empty(); });
+        }
+    }
+}
+
+void AssetManager::Finish() {
+    while(!Done()) {
+        if(Update(1.0f) == 0) {
+            std::unique_lock<std::mutex> guard(lock);
+            uploadReady.wait_for(guard, std::chrono::milliseconds(1), [this] { return !uploadQueue.empty(); });
+        }
+    }
+}
+
+AssetState AssetManager::State(AssetHandle handle) const {
+    return (AssetState)assets[handle]->state.load();
+}
+
+GLuint AssetManager::Texture(AssetHandle handle) const {
+    return State(handle) == ASSET_READY ? assets[handle]->texture : 0;
+}
+
+AssetProgress AssetManager::Progress() const {
+    AssetProgress progress;
+    progress.total = (int)assets.size();
+    progress.decoded = decoded;
+    progress.ready = ready;
+    progress.failed = failed;
+    progress.fraction = progress.total ? (float)(progress.ready + progress.failed) / progress.total : 1.0f;
+    return progress;
+}
+
+bool AssetManager::Done() const {
+    return ready + failed == (int)assets.size();
+}
+
+const TextureCache &AssetManager::Textures() const {
+    return textures;
+}
@@ -1,13 +1,24 @@
 
 #include "ShaderProgram.h"
 
-void ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShaderFile) {
+bool ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShaderFile) {
     
     // create the vertex shader
     vertexShader = LoadShaderFromFile(vertexShaderFile, GL_VERTEX_SHADER);
     // create the fragment shader
     fragmentShader = LoadShaderFromFile(fragmentShaderFile, GL_FRAGMENT_SHADER);
     
+    return Link();
+}
+
+bool ShaderProgram::LoadFromSource(const std::string &vertexSource, const std::string &fragmentSource) {
+    vertexShader = LoadShaderFromString(vertexSource, GL_VERTEX_SHADER);
+    fragmentShader = LoadShaderFromString(fragmentSource, GL_FRAGMENT_SHADER);
+    return Link();
+}
+
+bool ShaderProgram::Link() {
+    
     // Create the final shader program from our vertex and fragment shaders
     programID = glCreateProgram();
     glAttachShader(programID, vertexShader);
@@ -30,6 +41,7 @@ void ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShade
 	
 	SetColor(1.0f, 1.0f, 1.0f, 1.0f);
     
+    return linkSuccess == GL_TRUE;
 }
 
 void ShaderProgram::Cleanup() {
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+// Collects textured quads between Begin() and End(), transforms them on the CPU
+// and streams them into a single vertex buffer. End() sorts the quads by texture
+// (keeping submission order within a texture) and issues one draw per texture.
+class SpriteBatch {
+    public:
+        SpriteBatch();
+        ~SpriteBatch();
+
+        void Begin();
+        // positions and texCoords each hold six x, y pairs in sprite-local space
+        void Draw(unsigned int textureID, const glm::mat4 &modelMatrix, const float *positions, const float *texCoords);
+        void End(ShaderProgram &program);
+
+        // counters for the last End()
+        int drawCalls;
+        int spriteCount;
+
+    private:
+        SpriteBatch(const SpriteBatch &other);
+        SpriteBatch &operator=(const SpriteBatch &other);
+
+        struct Quad {
+            unsigned int textureID;
+            unsigned int order;
+            bool operator<(const Quad &other) const;
+        };
+
+        std::vector<Quad> quads;
+        // x, y, u, v for six vertices per quad, in submission order
+        std::vector<float> vertices;
+        // the same vertices regrouped by texture for upload
+        std::vector<float> sorted;
+        GLuint vbo;
+        GLsizeiptr vboSize;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// bumped whenever the file layout or the format choice changes, so old files are ignored
+#define TEXTURE_CACHE_VERSION 1
+
+// Pixels ready to hand to glTexImage2D as they are: rows tightly packed, in
+// whatever format Reduce() chose. They either point into a mapped cache
+// file or into data.
+struct CachedTexture {
+    CachedTexture() : width(0), height(0), internalFormat(GL_RGBA), format(GL_RGBA), pixels(NULL), mapping(NULL), mappingSize(0) {}
+    int width;
+    int height;
+    GLint internalFormat;
+    GLenum format;
+    const unsigned char *pixels;
+    void *mapping;
+    size_t mappingSize;
+    std::vector<unsigned char> data;
+};
+
+// Decoded textures kept on disk, keyed by a hash of the image file's bytes.
+// The first launch decodes each image once and writes out the pixels already
+// in their upload format, with as few channels as draw the same: opaque
+// images lose alpha, gray ones become luminance plus alpha, and a white
+// nearest-filtered font with on/off alpha becomes a single intensity
+// channel. Later launches map that file and skip decoding entirely.
+//
+// Load() is safe to call from several threads at once.
+class TextureCache {
+    public:
+        // directory ends in a path separator, as SDL_GetPrefPath()'s does. An
+        // empty one still reduces the format but never reads or writes files.
+        TextureCache(const std::string &directory);
+
+        bool Load(const std::string &fileName, bool nearest, CachedTexture &texture);
+        // Unmaps or frees the pixels once they are uploaded.
+        static void Release(CachedTexture &texture);
+        // Uploads to the texture currently bound to GL_TEXTURE_2D.
+        static void Upload(const CachedTexture &texture);
+
+        std::atomic<int> hits;
+        std::atomic<int> misses;
+
+    private:
+        TextureCache(const TextureCache &);
+        TextureCache &operator=(const TextureCache &);
+
+        bool Map(const std::string &path, unsigned long long key, CachedTexture &texture);
+        void Save(const std::string &path, unsigned long long key, const CachedTexture &texture);
+        static void Reduce(const unsigned char *rgba, int width, int height, bool nearest, CachedTexture &texture);
+
+        std::string directory;
+        std::atomic<int> saves;
+};
@@ -6,11 +6,20 @@
 #include <SDL_opengl.h>
 #include <SDL_image.h>
 #include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "AssetManager.h"
+#ifdef DEBUG
+#include "TextureAtlas.h"
+#else
+#include "SheetAtlas.h"
+#endif
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <vector>
+#include <type_traits>
+#include <stdio.h>
 
 #ifdef _WINDOWS
 #define RESOURCE_FOLDER ""
@@ -19,7 +28,15 @@
 #endif
 
 SDL_Window* displayWindow;
-GLuint LoadTexture(const char *filePath, int near);
+
+// Debug builds read sheet.xml at startup so edits show up without regenerating
+// SheetAtlas.h; release builds look names up at compile time.
+#ifdef DEBUG
+TextureAtlas sheetAtlas;
+#define SHEET_REGION(name) sheetAtlas.Get(name)
+#else
+#define SHEET_REGION(name) SheetAtlas::regions[std::integral_constant<int, SheetAtlas::find(name)>::value]
+#endif
 float lerp(float v0, float v1, float t);
 void DrawText(ShaderProgram &program, int fontTexture, std::string text, float size, float spacing, glm::vec3 position);
 
@@ -28,6 +45,8 @@ public:
     SheetSprite() {}
     SheetSprite(unsigned int textureID, float u, float v, float width, float height, float size)
     : textureID(textureID), u(u), v(v), width(width), height(height), size(size) {}
+    SheetSprite(unsigned int textureID, AtlasRegion region, float size)
+    : textureID(textureID), u(region.u), v(region.v), width(region.width), height(region.height), size(size) {}
     void DrawSprite(ShaderProgram &program)
     {
         glBindTexture(GL_TEXTURE_2D, textureID);
@@ -55,6 +74,26 @@ public:
         glDisableVertexAttribArray(program.positionAttribute);
         glDisableVertexAttribArray(program.texCoordAttribute);
     }
+    void DrawSprite(SpriteBatch &batch, const glm::mat4 &matrix)
+    {
+        GLfloat texCoords[] = {
+            u, v+height,
+            u+width, v,
+            u, v,
+            u+width, v,
+            u, v+height,
+            u+width, v+height
+        };
+        float aspect = width / height;
+        float vertices[] = {
+            -0.5f * size * aspect, -0.5f * size,
+            0.5f * size * aspect, 0.5f * size,
+            -0.5f * size * aspect, 0.5f * size,
+            0.5f * size * aspect, 0.5f * size,
+            -0.5f * size * aspect, -0.5f * size,
+            0.5f * size * aspect, -0.5f * size};
+        batch.Draw(textureID, matrix, vertices, texCoords);
+    }
     float size;
     unsigned int textureID;
     float u;
@@ -95,6 +134,11 @@ public:
         sprite.DrawSprite(program);
     }
     
+    void Draw(SpriteBatch &batch)
+    {
+        sprite.DrawSprite(batch, matrix);
+    }
+    
     bool collision(Entity otherEnt)
     {
         return (collisionX(otherEnt) < 0.0001f && collisionY(otherEnt) < 0.0001f);
@@ -133,322 +177,364 @@ int main(int argc, char *argv[])
     SDL_GL_MakeCurrent(displayWindow, context);
     
     ShaderProgram program;
-    program.Load(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl");
-    
-    GLuint fontSheet = LoadTexture(RESOURCE_FOLDER"pixel_font.png", 1);
-    GLuint spriteSheet = LoadTexture(RESOURCE_FOLDER"Space shooter assets (300 assets)/Spritesheet/sheet.png", 0);
-    
-    SheetSprite temp = SheetSprite(spriteSheet, 224.0f/1024.0f, 832.0f/1024.0f, 99.0f/1024.0f, 75.0f/1024.0f, 0.1f);
-    Entity ship(glm::vec3(0.0f, -0.85f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.1f, 0.1f, 0.0f), glm::vec3(10.0f, 1.0f, 0.0f), 0.0f, temp);
-    program.SetModelMatrix(ship.matrix);
-    
-#define MAX_BULLETS 10
-    int bulletIndex = 0;
-    float bulletSize = 0.05f;
-    Entity bullets[MAX_BULLETS];
-    SheetSprite bulletSprite = SheetSprite(spriteSheet, 856.0f/1024.0f, 602.0f/1024.0f, 9.0f/1024.0f, 37.0f/1024.0f, bulletSize);
-    for(int i=0; i < MAX_BULLETS; i++)
+    // SpriteBatch deletes its vertex buffer on destruction, so everything
+    // from here to the end of the loop goes before the context does
     {
-        bullets[i] = Entity(glm::vec3(0.0f, -20.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(bulletSize, bulletSize, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, bulletSprite);
-        program.SetModelMatrix(bullets[i].matrix);
-    }
+        SpriteBatch batch;
+        
+        // both sheets and the shader files are read side by side on worker threads;
+        // decoded textures are kept in the app's preferences folder for the next launch
+        std::string textureCachePath;
+        char *prefPath = SDL_GetPrefPath("NYU", "NYUCodebase");
+        if(prefPath)
+        {
+            textureCachePath = prefPath;
+            SDL_free(prefPath);
+        }
+        AssetManager assets(2, textureCachePath);
+        AssetHandle shaderHandle = assets.LoadShader(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl",
+            [&program](const std::string &vertex, const std::string &fragment) { return program.LoadFromSource(vertex, fragment); });
+        AssetHandle fontHandle = assets.LoadTexture(RESOURCE_FOLDER"pixel_font.png", true);
+        AssetHandle spriteHandle = assets.LoadTexture(RESOURCE_FOLDER"Space shooter assets (300 assets)/Spritesheet/sheet.png", false);
+#ifdef DEBUG
+        assets.Load([]() { return sheetAtlas.Load(RESOURCE_FOLDER"Space shooter assets (300 assets)/Spritesheet/sheet.xml", 1024.0f, 1024.0f); });
+#endif
+        assets.Finish();
+        // the game cannot draw without any of these, so it closes instead of running blank
+        bool loaded = assets.State(shaderHandle) == ASSET_READY && assets.State(fontHandle) == ASSET_READY && assets.State(spriteHandle) == ASSET_READY;
+        if(!loaded)
+        {
+            std::cout << "Unable to load the shader and textures\n";
+        }
+        GLuint fontSheet = assets.Texture(fontHandle);
+        GLuint spriteSheet = assets.Texture(spriteHandle);
+        
+        SheetSprite temp = SheetSprite(spriteSheet, SHEET_REGION("playerShip1_red.png"), 0.1f);
+        Entity ship(glm::vec3(0.0f, -0.85f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.1f, 0.1f, 0.0f), glm::vec3(10.0f, 1.0f, 0.0f), 0.0f, temp);
+        program.SetModelMatrix(ship.matrix);
+        
+#define MAX_BULLETS 10
+        int bulletIndex = 0;
+        float bulletSize = 0.05f;
+        Entity bullets[MAX_BULLETS];
+        SheetSprite bulletSprite = SheetSprite(spriteSheet, SHEET_REGION("laserRed03.png"), bulletSize);
+        for(int i=0; i < MAX_BULLETS; i++)
+        {
+            bullets[i] = Entity(glm::vec3(0.0f, -20.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(bulletSize, bulletSize, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, bulletSprite);
+            program.SetModelMatrix(bullets[i].matrix);
+        }
 
 #define MAX_ENEMY1 10
-    float enemy1Size = 0.05f;
-    SheetSprite enemy1Sprite = SheetSprite(spriteSheet, 346.0f/1024.0f, 150.0f/1024.0f, 97.0f/1024.0f, 84.0f/1024.0f, enemy1Size);
-    Entity enemy1[MAX_ENEMY1];
-    std::vector<glm::vec3> origPositions1;
-    for(int i = 0; i < MAX_ENEMY1; i++)
-    {
-        origPositions1.push_back(glm::vec3(-0.45f + (i*0.1f), 0.0f, 0.0f));
-        enemy1[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy1Size, enemy1Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy1Sprite);
-        program.SetModelMatrix(enemy1[i].matrix);
-    }
-    
+        float enemy1Size = 0.05f;
+        SheetSprite enemy1Sprite = SheetSprite(spriteSheet, SHEET_REGION("enemyBlack5.png"), enemy1Size);
+        Entity enemy1[MAX_ENEMY1];
+        std::vector<glm::vec3> origPositions1;
+        for(int i = 0; i < MAX_ENEMY1; i++)
+        {
+            origPositions1.push_back(glm::vec3(-0.45f + (i*0.1f), 0.0f, 0.0f));
+            enemy1[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy1Size, enemy1Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy1Sprite);
+            program.SetModelMatrix(enemy1[i].matrix);
+        }
+        
 #define MAX_ENEMY2 10
-    float enemy2Size = 0.05f;
-    SheetSprite enemy2Sprite = SheetSprite(spriteSheet, 222.0f/1024.0f, 0.0f/1024.0f, 103.0f/1024.0f, 84.0f/1024.0f, enemy2Size);
-    Entity enemy2[MAX_ENEMY2];
-    std::vector<glm::vec3> origPositions2;
-    for(int i = 0; i < MAX_ENEMY2; i++)
-    {
-        origPositions2.push_back(glm::vec3(-0.45f + (i*0.1f), 0.2f, 0.0f));
-        enemy2[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.2f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy2Size, enemy2Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy2Sprite);
-        program.SetModelMatrix(enemy2[i].matrix);
-    }
-    
+        float enemy2Size = 0.05f;
+        SheetSprite enemy2Sprite = SheetSprite(spriteSheet, SHEET_REGION("enemyBlue3.png"), enemy2Size);
+        Entity enemy2[MAX_ENEMY2];
+        std::vector<glm::vec3> origPositions2;
+        for(int i = 0; i < MAX_ENEMY2; i++)
+        {
+            origPositions2.push_back(glm::vec3(-0.45f + (i*0.1f), 0.2f, 0.0f));
+            enemy2[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.2f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy2Size, enemy2Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy2Sprite);
+            program.SetModelMatrix(enemy2[i].matrix);
+        }
+        
 #define MAX_ENEMY3 10
-    float enemy3Size = 0.05f;
-    SheetSprite enemy3Sprite = SheetSprite(spriteSheet, 133.0f/1024.0f, 412.0f/1024.0f, 104.0f/1024.0f, 84.0f/1024.0f, enemy3Size);
-    Entity enemy3[MAX_ENEMY3];
-    std::vector<glm::vec3> origPositions3;
-    for(int i = 0; i < MAX_ENEMY3; i++)
-    {
-        origPositions3.push_back(glm::vec3(-0.45f + (i*0.1f), 0.4f, 0.0f));
-        enemy3[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.4f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy3Size, enemy3Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy3Sprite);
-        program.SetModelMatrix(enemy3[i].matrix);
-    }
-    
-    glm::mat4 viewMatrix = glm::mat4(1.0f);
-    glm::mat4 projectionMatrix = glm::mat4(1.0f);
-    
-    float aspectRatio = screenHeight / screenWidth;
-    float projectionHeight = 1.0f;
-    float projectionWidth = projectionHeight * aspectRatio;
-    float projectionDepth = 1.0f;
-    projectionMatrix = glm::ortho(-projectionWidth, projectionWidth, -projectionHeight, projectionHeight,
-                                  -projectionDepth, projectionDepth);
-    
-    program.SetProjectionMatrix(projectionMatrix);
-    program.SetViewMatrix(viewMatrix);
-    
-    float lastFrameTicks = 0.0f;
-    float time = 0;
-    float enemyTime = 0;
-    float moveValue = 0.0125f;
-    float moveDirection = 1;
-    float noMore = 0;
-    bool moveDown = false;
-    
-    int gameMode = 0; // 0 = Main Menu, 1 = Game Level
-    
+        float enemy3Size = 0.05f;
+        SheetSprite enemy3Sprite = SheetSprite(spriteSheet, SHEET_REGION("enemyGreen2.png"), enemy3Size);
+        Entity enemy3[MAX_ENEMY3];
+        std::vector<glm::vec3> origPositions3;
+        for(int i = 0; i < MAX_ENEMY3; i++)
+        {
+            origPositions3.push_back(glm::vec3(-0.45f + (i*0.1f), 0.4f, 0.0f));
+            enemy3[i] = Entity(glm::vec3(-0.45f + (i*0.1f), 0.4f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(enemy3Size, enemy3Size, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), 0.0f, enemy3Sprite);
+            program.SetModelMatrix(enemy3[i].matrix);
+        }
+        
+        glm::mat4 viewMatrix = glm::mat4(1.0f);
+        glm::mat4 projectionMatrix = glm::mat4(1.0f);
+        
+        float aspectRatio = screenHeight / screenWidth;
+        float projectionHeight = 1.0f;
+        float projectionWidth = projectionHeight * aspectRatio;
+        float projectionDepth = 1.0f;
+        projectionMatrix = glm::ortho(-projectionWidth, projectionWidth, -projectionHeight, projectionHeight,
+                                      -projectionDepth, projectionDepth);
+        
+        program.SetProjectionMatrix(projectionMatrix);
+        program.SetViewMatrix(viewMatrix);
+        
+        float lastFrameTicks = 0.0f;
+        float time = 0;
+        float enemyTime = 0;
+        float moveValue = 0.0125f;
+        float moveDirection = 1;
+        float noMore = 0;
+        bool moveDown = false;
+        
+        int gameMode = 0; // 0 = Main Menu, 1 = Game Level
+        
 #ifdef _WINDOWS
-    glewInit();
+        glewInit();
 #endif
-    
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    glUseProgram(program.programID);
-
-    SDL_Event event;
-    bool done = false;
-    while (!done) {
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
-                done = true;
-            }
-        }
-        float ticks = (float)SDL_GetTicks()/1000.0f;
-        float elapsed = ticks - lastFrameTicks;
-        lastFrameTicks = ticks;
         
-        const Uint8 *keys = SDL_GetKeyboardState(NULL);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        
+        glUseProgram(program.programID);
 
-        glClear(GL_COLOR_BUFFER_BIT);
-        switch(gameMode)
-        {
-            case 0:
-                DrawText(program, fontSheet, "Space Invaders", 0.075f, 0.0009f, glm::vec3(-0.5f, 0.3f, 0.0f));
-                DrawText(program, fontSheet, "Press Enter", 0.06, 0.0009f, glm::vec3(-0.3, 0.1, 0.0));
-                DrawText(program, fontSheet, "To Start", 0.06, 0.0009f, glm::vec3(-0.2, -0.1, 0.0));
-                if(keys[SDL_SCANCODE_RETURN])
-                {
-                    gameMode = 1;
-                    for(int loop = 0; loop < MAX_ENEMY1; loop++)
-                    {
-                        enemy1[loop].isEnabled = true;
-                        enemy1[loop].position = origPositions1[loop];
-                    }
-                    for(int loop = 0; loop < MAX_ENEMY2; loop++)
-                    {
-                        enemy2[loop].isEnabled = true;
-                        enemy2[loop].position = origPositions2[loop];
-                    }
-                    for(int loop = 0; loop < MAX_ENEMY3; loop++)
-                    {
-                        enemy3[loop].isEnabled = true;
-                        enemy3[loop].position = origPositions3[loop];
-                    }
-                }
-            break;
-            case 1:
-                noMore = 0;
-                ship.Draw(program);
-                for(Entity& draw : bullets)
-                {
-                    draw.Draw(program);
-                }
-                for(Entity& draw : enemy1)
-                {
-                    if(draw.isEnabled)
-                    {
-                        draw.Draw(program);
-                        noMore++;
-                    }
-                }
-                for(Entity& draw : enemy2)
-                {
-                    if(draw.isEnabled)
-                    {
-                        draw.Draw(program);
-                        noMore++;
-                    }
-                }
-                for(Entity& draw : enemy3)
-                {
-                    if(draw.isEnabled)
-                    {
-                        draw.Draw(program);
-                        noMore++;
-                    }
-                }
-                if(noMore == 0)
-                {
-                    gameMode = 0;
-                    break;
+#ifdef DEBUG
+        // the batch's counters are printed once a second
+        Uint32 lastStatsTicks = SDL_GetTicks();
+#endif
+        SDL_Event event;
+        bool done = !loaded;
+        while (!done) {
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
+                    done = true;
                 }
-                
-                ship.Update(elapsed);
-                for(Entity& bullet : bullets)
-                {
-                    bullet.Update(elapsed);
-                    for(Entity& update : enemy1)
+            }
+            float ticks = (float)SDL_GetTicks()/1000.0f;
+            float elapsed = ticks - lastFrameTicks;
+            lastFrameTicks = ticks;
+            
+            const Uint8 *keys = SDL_GetKeyboardState(NULL);
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            switch(gameMode)
+            {
+                case 0:
+                    DrawText(program, fontSheet, "Space Invaders", 0.075f, 0.0009f, glm::vec3(-0.5f, 0.3f, 0.0f));
+                    DrawText(program, fontSheet, "Press Enter", 0.06, 0.0009f, glm::vec3(-0.3, 0.1, 0.0));
+                    DrawText(program, fontSheet, "To Start", 0.06, 0.0009f, glm::vec3(-0.2, -0.1, 0.0));
+                    if(keys[SDL_SCANCODE_RETURN])
                     {
-                        update.Update(elapsed);
-                        if(update.collision(bullet) && update.isEnabled)
-                        {
-                            bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
-                            bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-                            update.isEnabled = false;
-                        }
-                        if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
+                        gameMode = 1;
+                        for(int loop = 0; loop < MAX_ENEMY1; loop++)
                         {
-                            moveDirection = -1;
-                            moveDown = true;
+                            enemy1[loop].isEnabled = true;
+                            enemy1[loop].position = origPositions1[loop];
                         }
-                        if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                        for(int loop = 0; loop < MAX_ENEMY2; loop++)
                         {
-                            moveDirection = 1;
-                            moveDown = true;
+                            enemy2[loop].isEnabled = true;
+                            enemy2[loop].position = origPositions2[loop];
                         }
-                        if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                        for(int loop = 0; loop < MAX_ENEMY3; loop++)
                         {
-                            gameMode = 0;
-                            break;
+                            enemy3[loop].isEnabled = true;
+                            enemy3[loop].position = origPositions3[loop];
                         }
                     }
-                    for(Entity& update : enemy2)
+                break;
+                case 1:
+                    noMore = 0;
+                    batch.Begin();
+                    ship.Draw(batch);
+                    for(Entity& draw : bullets)
                     {
-                        update.Update(elapsed);
-                        if(update.collision(bullet) && update.isEnabled)
-                        {
-                            bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
-                            bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-                            update.isEnabled = false;
-                        }
-                        if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
-                        {
-                            moveDirection = -1;
-                            moveDown = true;
-                        }
-                        if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                        draw.Draw(batch);
+                    }
+                    for(Entity& draw : enemy1)
+                    {
+                        if(draw.isEnabled)
                         {
-                            moveDirection = 1;
-                            moveDown = true;
+                            draw.Draw(batch);
+                            noMore++;
                         }
-                        if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                    }
+                    for(Entity& draw : enemy2)
+                    {
+                        if(draw.isEnabled)
                         {
-                            gameMode = 0;
-                            break;
+                            draw.Draw(batch);
+                            noMore++;
                         }
                     }
-                    for(Entity& update : enemy3)
+                    for(Entity& draw : enemy3)
                     {
-                        update.Update(elapsed);
-                        if(update.collision(bullet) && update.isEnabled)
+                        if(draw.isEnabled)
                         {
-                            bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
-                            bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-                            update.isEnabled = false;
+                            draw.Draw(batch);
+                            noMore++;
                         }
-                        if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
+                    }
+                    batch.End(program);
+                    if(noMore == 0)
+                    {
+                        gameMode = 0;
+                        break;
+                    }
+                    
+                    ship.Update(elapsed);
+                    for(Entity& bullet : bullets)
+                    {
+                        bullet.Update(elapsed);
+                        for(Entity& update : enemy1)
                         {
-                            moveDirection = -1;
-                            moveDown = true;
+                            update.Update(elapsed);
+                            if(update.collision(bullet) && update.isEnabled)
+                            {
+                                bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
+                                bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+                                update.isEnabled = false;
+                            }
+                            if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = -1;
+                                moveDown = true;
+                            }
+                            if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = 1;
+                                moveDown = true;
+                            }
+                            if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                            {
+                                gameMode = 0;
+                                break;
+                            }
                         }
-                        if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                        for(Entity& update : enemy2)
                         {
-                            moveDirection = 1;
-                            moveDown = true;
+                            update.Update(elapsed);
+                            if(update.collision(bullet) && update.isEnabled)
+                            {
+                                bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
+                                bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+                                update.isEnabled = false;
+                            }
+                            if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = -1;
+                                moveDown = true;
+                            }
+                            if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = 1;
+                                moveDown = true;
+                            }
+                            if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                            {
+                                gameMode = 0;
+                                break;
+                            }
                         }
-                        if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                        for(Entity& update : enemy3)
                         {
-                            gameMode = 0;
-                            break;
+                            update.Update(elapsed);
+                            if(update.collision(bullet) && update.isEnabled)
+                            {
+                                bullet.position = glm::vec3(0.0f, -20.0f, 0.0f);
+                                bullet.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+                                update.isEnabled = false;
+                            }
+                            if((update.position.x + update.size.x) > projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = -1;
+                                moveDown = true;
+                            }
+                            if((update.position.x - update.size.x) < -projectionWidth && update.isEnabled)
+                            {
+                                moveDirection = 1;
+                                moveDown = true;
+                            }
+                            if((update.collision(ship) && update.isEnabled) || update.position.y < -0.95f)
+                            {
+                                gameMode = 0;
+                                break;
+                            }
                         }
                     }
-                }
-                
-                if(keys[SDL_SCANCODE_RIGHT])
-                {
-                    ship.velocity.x = 0.85f;
-                }
-                if(keys[SDL_SCANCODE_LEFT])
-                {
-                    ship.velocity.x = -0.85f;
-                }
-                if((ship.position.x + ship.size.x/2) > projectionWidth)
-                {
-                    ship.position.x = projectionWidth - 0.1f;
-                }
-                if((ship.position.x - ship.size.x/2) < -projectionWidth)
-                {
-                    ship.position.x = -projectionWidth + 0.1f;
-                }
-                if(keys[SDL_SCANCODE_SPACE] && time > 0.5f)
-                {
-                    bullets[bulletIndex].matrix = glm::mat4(1.0f);
-                    bullets[bulletIndex].position = ship.position;
-                    bullets[bulletIndex].velocity = glm::vec3(0.0f, 2.0f, 0.0f);
-                    bulletIndex++;
-                    if(bulletIndex >= MAX_BULLETS)
+                    
+                    if(keys[SDL_SCANCODE_RIGHT])
                     {
-                        bulletIndex = 0;
+                        ship.velocity.x = 0.85f;
                     }
-                    time = 0;
-                }
-                time += elapsed;
-                
-                if(enemyTime > 0.75f)
-                {
-                    for(Entity& move : enemy1)
+                    if(keys[SDL_SCANCODE_LEFT])
+                    {
+                        ship.velocity.x = -0.85f;
+                    }
+                    if((ship.position.x + ship.size.x/2) > projectionWidth)
+                    {
+                        ship.position.x = projectionWidth - 0.1f;
+                    }
+                    if((ship.position.x - ship.size.x/2) < -projectionWidth)
                     {
-                        move.position.x += moveValue * moveDirection;
-                        if(moveDown)
+                        ship.position.x = -projectionWidth + 0.1f;
+                    }
+                    if(keys[SDL_SCANCODE_SPACE] && time > 0.5f)
+                    {
+                        bullets[bulletIndex].matrix = glm::mat4(1.0f);
+                        bullets[bulletIndex].position = ship.position;
+                        bullets[bulletIndex].velocity = glm::vec3(0.0f, 2.0f, 0.0f);
+                        bulletIndex++;
+                        if(bulletIndex >= MAX_BULLETS)
                         {
-                            move.position.y -= moveValue * 4;
+                            bulletIndex = 0;
                         }
+                        time = 0;
                     }
-                    for(Entity& move : enemy2)
+                    time += elapsed;
+                    
+                    if(enemyTime > 0.75f)
                     {
-                        move.position.x += moveValue * moveDirection;
-                        if(moveDown)
+                        for(Entity& move : enemy1)
                         {
-                            move.position.y -= moveValue * 4;
+                            move.position.x += moveValue * moveDirection;
+                            if(moveDown)
+                            {
+                                move.position.y -= moveValue * 4;
+                            }
                         }
+                        for(Entity& move : enemy2)
+                        {
+                            move.position.x += moveValue * moveDirection;
+                            if(moveDown)
+                            {
+                                move.position.y -= moveValue * 4;
+                            }
 
-                    }
-                    for(Entity& move : enemy3)
-                    {
-                        move.position.x += moveValue * moveDirection;
-                        if(moveDown)
+                        }
+                        for(Entity& move : enemy3)
                         {
-                            move.position.y -= moveValue * 4;
+                            move.position.x += moveValue * moveDirection;
+                            if(moveDown)
+                            {
+                                move.position.y -= moveValue * 4;
+                            }
                         }
+                        enemyTime = 0;
+                        moveDown = false;
                     }
-                    enemyTime = 0;
-                    moveDown = false;
-                }
-                enemyTime += elapsed;
-                
-                break;
+                    enemyTime += elapsed;
+                    
+                    break;
+            }
+            
+            
+            SDL_GL_SwapWindow(displayWindow);
+#ifdef DEBUG
+            if(SDL_GetTicks() - lastStatsTicks >= 1000)
+            {
+                printf("sprites: %d in %d draw calls\n", batch.spriteCount, batch.drawCalls);
+                lastStatsTicks = SDL_GetTicks();
+            }
+#endif
         }
-        
-        
-        SDL_GL_SwapWindow(displayWindow);
     }
     
+    SDL_GL_DeleteContext(context);
     SDL_Quit();
     return 0;
 }
@@ -458,32 +544,6 @@ float lerp(float v0, float v1, float t)
     return (1.0f-t)*v0 + t*v1;
 }
 
-GLuint LoadTexture(const char *filePath, int near) {
-    int w,h,comp;
-    unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-    if(image == NULL) {
-        std::cout << "Unable to load image. Make sure the path is correct\n";
-        assert(false);
-    }
-    GLuint retTexture;
-    glGenTextures(1, &retTexture);
-    glBindTexture(GL_TEXTURE_2D, retTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    if(near)
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    }
-    else
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    stbi_image_free(image);
-    return retTexture;
-}
-
-
 void DrawText(ShaderProgram &program, int fontTexture, std::string text, float size, float spacing, glm::vec3 position) {
     glm::mat4 textMatrix = glm::mat4(1.0f);
     textMatrix = glm::translate(textMatrix, position);
@@ -0,0 +1,65 @@
+#include "FrameScheduler.h"
+#include <math.h>
+#include <iostream>
+
+// bounds for how far ahead of the deadline a sleep ends, in seconds
+#define FRAME_MIN_SLEEP_MARGIN 0.0005
+#define FRAME_MAX_SLEEP_MARGIN 0.004
+
+FrameScheduler::FrameScheduler(float timestep, int maxSteps) : timestep(timestep), maxSteps(maxSteps), pacing(PACING_SLEEP_SPIN), droppedSteps(0), accumulator(0.0), sleepMargin(0.002) {
+    frequency = (double)SDL_GetPerformanceFrequency();
+    last = SDL_GetPerformanceCounter();
+}
+
+void FrameScheduler::SetPacing(FramePacing pacing) {
+    if(pacing == PACING_VSYNC && SDL_GL_SetSwapInterval(1) != 0) {
+        std::cout << "Vsync unavailable, pacing frames with sleep instead: " << SDL_GetError() << "\n";
+        pacing = PACING_SLEEP_SPIN;
+    }
+    if(pacing == PACING_SLEEP_SPIN) {
+        SDL_GL_SetSwapInterval(0);
+    }
+    this->pacing = pacing;
+}
+
+void FrameScheduler::Reset() {
+    last = SDL_GetPerformanceCounter();
+    accumulator = 0.0;
+}
+
+double FrameScheduler::Advance() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double elapsed = (double)(now - last) / frequency;
+    last = now;
+    accumulator += elapsed;
+    return elapsed;
+}
+
+int FrameScheduler::BeginFrame() {
+    Advance();
+    if(pacing == PACING_SLEEP_SPIN) {
+        while(accumulator < timestep) {
+            double remaining = timestep - accumulator;
+            Uint32 sleep = remaining > sleepMargin ? (Uint32)((remaining - sleepMargin) * 1000.0) : 0;
+            if(sleep > 0) {
+                SDL_Delay(sleep);
+                double overslept = Advance() - sleep / 1000.0;
+                sleepMargin = fmax(FRAME_MIN_SLEEP_MARGIN, fmin(FRAME_MAX_SLEEP_MARGIN, fmax(overslept, sleepMargin * 0.99)));
+            } else {
+                Advance();
+            }
+        }
+    }
+
+    int steps = (int)(accumulator / timestep);
+    accumulator -= steps * (double)timestep;
+    if(steps > maxSteps) {
+        droppedSteps += steps - maxSteps;
+        steps = maxSteps;
+    }
+    return steps;
+}
+
+float FrameScheduler::Alpha() const {
+    return (float)(accumulator / timestep);
+}
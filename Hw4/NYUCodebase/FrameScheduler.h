@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SDL.h>
+
+enum FramePacing {
+    // sleep most of the wait away, then spin on the performance counter for the rest
+    PACING_SLEEP_SPIN,
+    // let SDL_GL_SwapWindow block on the display and only measure time here
+    PACING_VSYNC
+};
+
+// Fixed timestep clock for the main loop. BeginFrame() waits until at least one
+// step is due (unless the swap is already paced by vsync) and says how many
+// steps to simulate; time beyond maxSteps is dropped so a hitch can't snowball.
+class FrameScheduler {
+    public:
+        FrameScheduler(float timestep, int maxSteps);
+
+        // Vsync needs a current GL context; falls back to sleep pacing if the driver refuses it.
+        void SetPacing(FramePacing pacing);
+        // Forgets time spent before the loop starts, e.g. while loading.
+        void Reset();
+        // Returns the number of fixed steps to run this frame.
+        int BeginFrame();
+        // How far into the next step the clock is, from 0 to 1, for interpolating the render.
+        float Alpha() const;
+
+        float timestep;
+        int maxSteps;
+        FramePacing pacing;
+
+        unsigned int droppedSteps;
+
+    private:
+        double Advance();
+
+        double frequency;
+        Uint64 last;
+        double accumulator;
+        // how early to wake up before the deadline, grown when SDL_Delay oversleeps
+        double sleepMargin;
+};
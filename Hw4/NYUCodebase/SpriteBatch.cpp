@@ -0,0 +1,83 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+SpriteBatch::SpriteBatch() : drawCalls(0), spriteCount(0), vbo(0), vboSize(0) {}
+
+SpriteBatch::~SpriteBatch() {
+    if(vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+    }
+}
+
+bool SpriteBatch::Quad::operator<(const Quad &other) const {
+    if(textureID != other.textureID) {
+        return textureID < other.textureID;
+    }
+    return order < other.order;
+}
+
+void SpriteBatch::Begin() {
+    quads.clear();
+    vertices.clear();
+}
+
+void SpriteBatch::Draw(unsigned int textureID, const glm::mat4 &modelMatrix, const float *positions, const float *texCoords) {
+    Quad quad;
+    quad.textureID = textureID;
+    quad.order = (unsigned int)quads.size();
+    quads.push_back(quad);
+    for(int i = 0; i < 6; i++) {
+        glm::vec4 transformed = modelMatrix * glm::vec4(positions[i*2], positions[i*2+1], 0.0f, 1.0f);
+        vertices.push_back(transformed.x);
+        vertices.push_back(transformed.y);
+        vertices.push_back(texCoords[i*2]);
+        vertices.push_back(texCoords[i*2+1]);
+    }
+}
+
+void SpriteBatch::End(ShaderProgram &program) {
+    drawCalls = 0;
+    spriteCount = (int)quads.size();
+    if(quads.empty()) {
+        return;
+    }
+    std::sort(quads.begin(), quads.end());
+    sorted.resize(vertices.size());
+    for(size_t i = 0; i < quads.size(); i++) {
+        std::copy(vertices.begin() + quads[i].order * 24, vertices.begin() + quads[i].order * 24 + 24, sorted.begin() + i * 24);
+    }
+
+    if(vbo == 0) {
+        glGenBuffers(1, &vbo);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLsizeiptr size = (GLsizeiptr)(sorted.size() * sizeof(float));
+    if(size > vboSize) {
+        vboSize = size;
+    }
+    // orphan last frame's storage so the upload never waits on the previous draw
+    glBufferData(GL_ARRAY_BUFFER, vboSize, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, sorted.data());
+
+    program.SetModelMatrix(glm::mat4(1.0f));
+    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(program.positionAttribute);
+    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(program.texCoordAttribute);
+
+    size_t start = 0;
+    while(start < quads.size()) {
+        size_t end = start + 1;
+        while(end < quads.size() && quads[end].textureID == quads[start].textureID) {
+            end++;
+        }
+        glBindTexture(GL_TEXTURE_2D, quads[start].textureID);
+        glDrawArrays(GL_TRIANGLES, (GLint)(start * 6), (GLsizei)((end - start) * 6));
+        drawCalls++;
+        start = end;
+    }
+
+    glDisableVertexAttribArray(program.positionAttribute);
+    glDisableVertexAttribArray(program.texCoordAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -6,12 +6,17 @@
 #include <SDL_opengl.h>
 #include <SDL_image.h>
 #include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "FrameScheduler.h"
 #include "glm/mat4x4.hpp"
 #include "FlareMap.h"
+#include "AssetManager.h"
 #include "glm/gtc/matrix_transform.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <vector>
+#include <string.h>
+#include <stdio.h>
 
 #ifdef _WINDOWS
 #define RESOURCE_FOLDER ""
@@ -24,7 +29,6 @@
 #define SPRITE_COUNT_Y 8
 
 SDL_Window* displayWindow;
-GLuint LoadTexture(const char *filePath, int near);
 void drawMap(ShaderProgram& program, FlareMap& map, unsigned int fontsheet);
 float lerp(float v0, float v1, float t) { return (1.0-t)*v0 + t*v1; }
 void worldToTileCoordinates(float worldX, float worldY, int& gridX, int& gridY)
@@ -83,6 +87,26 @@ public:
         glDisableVertexAttribArray(program.positionAttribute);
         glDisableVertexAttribArray(program.texCoordAttribute);
     }
+    void DrawSprite(SpriteBatch &batch, const glm::mat4 &matrix)
+    {
+        GLfloat texCoords[] = {
+            u, v+height,
+            u+width, v,
+            u, v,
+            u+width, v,
+            u, v+height,
+            u+width, v+height
+        };
+        float vertices[] = {
+            -0.5f * size, -0.5f * size,
+            0.5f * size, 0.5f * size,
+            -0.5f * size, 0.5f * size,
+            0.5f * size, 0.5f * size,
+            -0.5f * size, -0.5f * size,
+            0.5f * size, -0.5f * size
+        };
+        batch.Draw(textureID, matrix, vertices, texCoords);
+    }
     float size;
     unsigned int textureID;
     float u;
@@ -134,6 +158,15 @@ public:
             sprite.DrawSprite(program);
         }
     }
+    void Render(SpriteBatch& batch)
+    {
+        if(isEnabled)
+        {
+            matrix = glm::mat4(1.0f);
+            matrix = glm::translate(matrix, position);
+            sprite.DrawSprite(batch, matrix);
+        }
+    }
     void Update(const Uint8* keys, float elapsed, FlareMap& map)
     {
         velocity.x = lerp(velocity.x, 0.0f, elapsed * friction.x);
@@ -252,140 +285,144 @@ int main(int argc, char *argv[])
     SDL_GL_MakeCurrent(displayWindow, context);
     
     ShaderProgram program;
-    program.Load(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl");
-    
-    FlareMap map;
-    
-    GLuint tileSheet = LoadTexture(RESOURCE_FOLDER"sprites.png", 1);
-    map.Load(RESOURCE_FOLDER"TileMapTest.txt");
-    
-    float tempX = 0;
-    float tempY = 0;
-    tileToWorldCoordinates(map.entities[0].x, map.entities[0].y, tempX, tempY);
-    Entity enemy2(tempX, tempY+TILE_SIZE);
-    enemy2.sprite = SheetSprite(tileSheet, 81, TILE_SIZE);
-    program.SetModelMatrix(enemy2.matrix);
-    tileToWorldCoordinates(map.entities[1].x, map.entities[1].y, tempX, tempY);
-    Entity enemy1(tempX, tempY+TILE_SIZE);
-    enemy1.sprite = SheetSprite(tileSheet, 81, TILE_SIZE);
-    tileToWorldCoordinates(map.entities[2].x, map.entities[2].y, tempX, tempY);
-    program.SetModelMatrix(enemy1.matrix);
-    Entity player(tempX, tempY+TILE_SIZE);
-    player.sprite = SheetSprite(tileSheet, 98, TILE_SIZE);
-    program.SetModelMatrix(player.matrix);
-    
-    glm::mat4 projectionMatrix = glm::mat4(1.0f);
-    
-    float aspectRatio = screenWidth / screenHeight;
-    float projectionHeight = 1.0f;
-    float projectionWidth = projectionHeight * aspectRatio;
-    float projectionDepth = 1.0f;
-    projectionMatrix = glm::ortho(-projectionWidth, projectionWidth, -projectionHeight, projectionHeight,
-                                  -projectionDepth, projectionDepth);
-    program.SetProjectionMatrix(projectionMatrix);
-    
-    glm::mat4 viewMatrix = glm::mat4(1.0f);
-    viewMatrix = glm::translate(viewMatrix, glm::vec3(player.position.x, -player.position.y, 0.0f));
-    program.SetViewMatrix(viewMatrix);
-    
-    glClearColor(0.0f, 0.86f, 1.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    // SpriteBatch deletes its vertex buffer on destruction, so everything
+    // from here to the end of the loop goes before the context does
+    {
+        SpriteBatch batch;
+        
+        FlareMap map;
+        
+        // the sheet, the shader files and the map are read side by side on worker threads;
+        // decoded textures are kept in the app's preferences folder for the next launch
+        std::string textureCachePath;
+        char *prefPath = SDL_GetPrefPath("NYU", "NYUCodebase");
+        if(prefPath)
+        {
+            textureCachePath = prefPath;
+            SDL_free(prefPath);
+        }
+        AssetManager assets(2, textureCachePath);
+        AssetHandle shaderHandle = assets.LoadShader(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl",
+            [&program](const std::string &vertex, const std::string &fragment) { return program.LoadFromSource(vertex, fragment); });
+        AssetHandle tileHandle = assets.LoadTexture(RESOURCE_FOLDER"sprites.png", true);
+        assets.Load([&map]() { map.Load(RESOURCE_FOLDER"TileMapTest.txt"); return true; });
+        assets.Finish();
+        // the game cannot draw without any of these, so it closes instead of running blank
+        bool loaded = assets.State(shaderHandle) == ASSET_READY && assets.State(tileHandle) == ASSET_READY;
+        if(!loaded)
+        {
+            std::cout << "Unable to load the shader and tile sheet\n";
+        }
+        GLuint tileSheet = assets.Texture(tileHandle);
+        
+        float tempX = 0;
+        float tempY = 0;
+        tileToWorldCoordinates(map.entities[0].x, map.entities[0].y, tempX, tempY);
+        Entity enemy2(tempX, tempY+TILE_SIZE);
+        enemy2.sprite = SheetSprite(tileSheet, 81, TILE_SIZE);
+        program.SetModelMatrix(enemy2.matrix);
+        tileToWorldCoordinates(map.entities[1].x, map.entities[1].y, tempX, tempY);
+        Entity enemy1(tempX, tempY+TILE_SIZE);
+        enemy1.sprite = SheetSprite(tileSheet, 81, TILE_SIZE);
+        tileToWorldCoordinates(map.entities[2].x, map.entities[2].y, tempX, tempY);
+        program.SetModelMatrix(enemy1.matrix);
+        Entity player(tempX, tempY+TILE_SIZE);
+        player.sprite = SheetSprite(tileSheet, 98, TILE_SIZE);
+        program.SetModelMatrix(player.matrix);
+        
+        glm::mat4 projectionMatrix = glm::mat4(1.0f);
+        
+        float aspectRatio = screenWidth / screenHeight;
+        float projectionHeight = 1.0f;
+        float projectionWidth = projectionHeight * aspectRatio;
+        float projectionDepth = 1.0f;
+        projectionMatrix = glm::ortho(-projectionWidth, projectionWidth, -projectionHeight, projectionHeight,
+                                      -projectionDepth, projectionDepth);
+        program.SetProjectionMatrix(projectionMatrix);
+        
+        glm::mat4 viewMatrix = glm::mat4(1.0f);
+        viewMatrix = glm::translate(viewMatrix, glm::vec3(player.position.x, -player.position.y, 0.0f));
+        program.SetViewMatrix(viewMatrix);
+        
+        glClearColor(0.0f, 0.86f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-    float lastFrameTicks = 0.0f;
-    
-    // 60 FPS (1.0f/60.0f) (update sixty times a second)
+        // 60 FPS (1.0f/60.0f) (update sixty times a second)
 #define FIXED_TIMESTEP 0.0166666f
 #define MAX_TIMESTEPS 6
-    float accumulator = 0.0f;
-    
+        FrameScheduler scheduler(FIXED_TIMESTEP, MAX_TIMESTEPS);
+        // --vsync lets the display pace frames instead of sleeping
+        scheduler.SetPacing(argc > 1 && strcmp(argv[1], "--vsync") == 0 ? PACING_VSYNC : PACING_SLEEP_SPIN);
+        
 #ifdef _WINDOWS
-    glewInit();
+        glewInit();
 #endif
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    SDL_Event event;
-    bool done = false;
-    while (!done) {
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
-                done = true;
-            }
-            else if(event.type == SDL_KEYDOWN)
-            {
-                if(event.key.keysym.scancode == SDL_SCANCODE_SPACE)
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+#ifdef DEBUG
+        // the batch's counters are printed once a second
+        Uint32 lastStatsTicks = SDL_GetTicks();
+#endif
+        SDL_Event event;
+        bool done = !loaded;
+        scheduler.Reset();
+        while (!done) {
+            int steps = scheduler.BeginFrame();
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
+                    done = true;
+                }
+                else if(event.type == SDL_KEYDOWN)
                 {
-                    player.jump();
+                    if(event.key.keysym.scancode == SDL_SCANCODE_SPACE)
+                    {
+                        player.jump();
+                    }
                 }
             }
-        }
-        const Uint8 *keys = SDL_GetKeyboardState(NULL);
-        glClear(GL_COLOR_BUFFER_BIT);
+            const Uint8 *keys = SDL_GetKeyboardState(NULL);
+            glClear(GL_COLOR_BUFFER_BIT);
 
-        float ticks = (float)SDL_GetTicks()/1000.0f;
-        float elapsed = ticks - lastFrameTicks;
-        lastFrameTicks = ticks;
-        elapsed += accumulator;
-        if(elapsed < FIXED_TIMESTEP)
-        {
-            accumulator = elapsed;
-            continue;
-        }
-        while(elapsed >= FIXED_TIMESTEP)
-        {
-            player.Update(keys, FIXED_TIMESTEP, map);
-            enemy1.Update(keys, FIXED_TIMESTEP, map);
-            enemy2.Update(keys, FIXED_TIMESTEP, map);
-            elapsed -= FIXED_TIMESTEP;
-        }
-        accumulator = elapsed;
-        
-        player.EntityCollision(enemy1);
-        player.EntityCollision(enemy2);
-        
-        player.ProcessInput(keys);
+            for(int step = 0; step < steps; step++)
+            {
+                player.Update(keys, FIXED_TIMESTEP, map);
+                enemy1.Update(keys, FIXED_TIMESTEP, map);
+                enemy2.Update(keys, FIXED_TIMESTEP, map);
+            }
+            
+            player.EntityCollision(enemy1);
+            player.EntityCollision(enemy2);
+            
+            player.ProcessInput(keys);
 
-        viewMatrix = glm::mat4(1.0f);
-        viewMatrix = glm::translate(viewMatrix, glm::vec3(-player.position.x, -player.position.y, 0.0f));
-        program.SetViewMatrix(viewMatrix);
-        
-        drawMap(program, map, tileSheet);
-        player.Render(program);
-        enemy1.Render(program);
-        enemy2.Render(program);
-        
-        SDL_GL_SwapWindow(displayWindow);
+            viewMatrix = glm::mat4(1.0f);
+            viewMatrix = glm::translate(viewMatrix, glm::vec3(-player.position.x, -player.position.y, 0.0f));
+            program.SetViewMatrix(viewMatrix);
+            
+            drawMap(program, map, tileSheet);
+            batch.Begin();
+            player.Render(batch);
+            enemy1.Render(batch);
+            enemy2.Render(batch);
+            batch.End(program);
+            
+            SDL_GL_SwapWindow(displayWindow);
+#ifdef DEBUG
+            if(SDL_GetTicks() - lastStatsTicks >= 1000)
+            {
+                printf("sprites: %d in %d draw calls\n", batch.spriteCount, batch.drawCalls);
+                lastStatsTicks = SDL_GetTicks();
+            }
+#endif
+        }
     }
     
+    SDL_GL_DeleteContext(context);
     SDL_Quit();
     return 0;
 }
 
-GLuint LoadTexture(const char *filePath, int near) {
-    int w,h,comp;
-    unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-    if(image == NULL) {
-        std::cout << "Unable to load image. Make sure the path is correct\n";
-        assert(false);
-    }
-    GLuint retTexture;
-    glGenTextures(1, &retTexture);
-    glBindTexture(GL_TEXTURE_2D, retTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    if(near)
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    }
-    else
-    {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    stbi_image_free(image);
-    return retTexture;
-}
-
 void drawMap(ShaderProgram& program, FlareMap& map, unsigned int mapSheet)
 {
     glm::mat4 mapMatrix = glm::mat4(1.0f);